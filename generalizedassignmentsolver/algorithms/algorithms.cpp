@@ -13,6 +13,12 @@
 #include "generalizedassignmentsolver/algorithms/greedy.hpp"
 #include "generalizedassignmentsolver/algorithms/repair.hpp"
 #include "generalizedassignmentsolver/algorithms/localsearch.hpp"
+#include "generalizedassignmentsolver/algorithms/penaltylocalsearch.hpp"
+#include "generalizedassignmentsolver/algorithms/tabusearch.hpp"
+#include "generalizedassignmentsolver/algorithms/pathrelinking.hpp"
+#include "generalizedassignmentsolver/algorithms/largeneighborhoodsearch.hpp"
+#include "generalizedassignmentsolver/algorithms/memeticalgorithm.hpp"
+#include "generalizedassignmentsolver/algorithms/grasp.hpp"
 #include "generalizedassignmentsolver/algorithms/localsolver.hpp"
 
 #include <boost/program_options.hpp>
@@ -63,6 +69,12 @@ LocalSearchOptionalParameters read_localsearch_args(const std::vector<char*>& ar
     po::options_description desc("Allowed options");
     desc.add_options()
         ("threads,t", po::value<Counter>(&parameters.thread_number), "")
+        ("ejection-chain-length,e", po::value<Counter>(&parameters.ejection_chain_maximum_length), "")
+        ("candidate-agents,k", po::value<AgentPos>(&parameters.candidate_agent_number), "")
+        ("ejection-chain-agents", po::value<AgentPos>(&parameters.ejection_chain_agent_number), "")
+        ("ejection-chain-items", po::value<ItemPos>(&parameters.ejection_chain_item_number), "")
+        ("neighborhood-threads,n", po::value<Counter>(&parameters.neighborhood_thread_number), "")
+        ("perturbations,p", po::value<Counter>(&parameters.perturbation_number), "")
         ;
     po::variables_map vm;
     po::store(po::parse_command_line((Counter)argv.size(), argv.data(), desc), vm);
@@ -75,6 +87,171 @@ LocalSearchOptionalParameters read_localsearch_args(const std::vector<char*>& ar
     return parameters;
 }
 
+PenaltyLocalSearchOptionalParameters read_penaltylocalsearch_args(const std::vector<char*>& argv)
+{
+    PenaltyLocalSearchOptionalParameters parameters;
+    po::options_description desc("Allowed options");
+    desc.add_options()
+        ("threads,t", po::value<Counter>(&parameters.thread_number), "")
+        ("iteration-limit,i", po::value<Counter>(&parameters.iteration_limit), "")
+        ("initial-penalty,p", po::value<PCost>(&parameters.initial_penalty), "")
+        ("delta-inc", po::value<PCost>(&parameters.delta_inc), "")
+        ("delta-dec", po::value<PCost>(&parameters.delta_dec), "")
+        ("swap-agents", po::value<AgentPos>(&parameters.swap_agent_number), "")
+        ;
+    po::variables_map vm;
+    po::store(po::parse_command_line((Counter)argv.size(), argv.data(), desc), vm);
+    try {
+        po::notify(vm);
+    } catch (const po::required_option& e) {
+        std::cout << desc << std::endl;;
+        throw "";
+    }
+    return parameters;
+}
+
+TabuSearchOptionalParameters read_tabusearch_args(const std::vector<char*>& argv)
+{
+    TabuSearchOptionalParameters parameters;
+    po::options_description desc("Allowed options");
+    desc.add_options()
+        ("iteration-limit,i", po::value<Counter>(&parameters.iteration_limit), "")
+        ("tenure,l", po::value<Counter>(&parameters.tabu_tenure), "")
+        ("frequency-penalty,f", po::value<double>(&parameters.frequency_penalty), "")
+        ("elite-size,e", po::value<Counter>(&parameters.elite_size), "")
+        ("elite-minimum-distance", po::value<ItemIdx>(&parameters.elite_minimum_distance), "")
+        ("restart-interval,r", po::value<Counter>(&parameters.restart_interval), "")
+        ("initial-penalty,p", po::value<PCost>(&parameters.initial_penalty), "")
+        ("delta-inc", po::value<PCost>(&parameters.delta_inc), "")
+        ("delta-dec", po::value<PCost>(&parameters.delta_dec), "")
+        ("swap-agents", po::value<AgentPos>(&parameters.swap_agent_number), "")
+        ("neighborhood-evaluation-interval", po::value<Counter>(&parameters.neighborhood_evaluation_interval), "")
+        ;
+    po::variables_map vm;
+    po::store(po::parse_command_line((Counter)argv.size(), argv.data(), desc), vm);
+    try {
+        po::notify(vm);
+    } catch (const po::required_option& e) {
+        std::cout << desc << std::endl;;
+        throw "";
+    }
+    return parameters;
+}
+
+PathRelinkingOptionalParameters read_pathrelinking_args(const std::vector<char*>& argv)
+{
+    PathRelinkingOptionalParameters parameters;
+    po::options_description desc("Allowed options");
+    desc.add_options()
+        ("threads,t", po::value<Counter>(&parameters.thread_number), "")
+        ("iteration-limit,i", po::value<Counter>(&parameters.iteration_limit), "")
+        ("elite-size,e", po::value<Counter>(&parameters.elite_size), "")
+        ("pool-iteration-limit", po::value<Counter>(&parameters.pool_iteration_limit), "")
+        ("minimum-distance,d", po::value<ItemIdx>(&parameters.minimum_distance), "")
+        ("local-search-number,l", po::value<Counter>(&parameters.local_search_number), "")
+        ("local-search-iteration-limit", po::value<Counter>(&parameters.local_search_iteration_limit), "")
+        ("local-search-initial-penalty", po::value<PCost>(&parameters.local_search_initial_penalty), "")
+        ;
+    po::variables_map vm;
+    po::store(po::parse_command_line((Counter)argv.size(), argv.data(), desc), vm);
+    try {
+        po::notify(vm);
+    } catch (const po::required_option& e) {
+        std::cout << desc << std::endl;;
+        throw "";
+    }
+    return parameters;
+}
+
+LargeNeighborhoodSearchOptionalParameters read_largeneighborhoodsearch_args(const std::vector<char*>& argv)
+{
+    LargeNeighborhoodSearchOptionalParameters parameters;
+    po::options_description desc("Allowed options");
+    desc.add_options()
+        ("threads,t", po::value<Counter>(&parameters.thread_number), "")
+        ("iteration-limit,i", po::value<Counter>(&parameters.iteration_limit), "")
+        ("minimum-agent-number", po::value<AgentIdx>(&parameters.minimum_agent_number), "")
+        ("maximum-agent-number", po::value<AgentIdx>(&parameters.maximum_agent_number), "")
+        ("subproblem-time-limit", po::value<double>(&parameters.subproblem_time_limit), "")
+        ;
+    po::variables_map vm;
+    po::store(po::parse_command_line((Counter)argv.size(), argv.data(), desc), vm);
+    try {
+        po::notify(vm);
+    } catch (const po::required_option& e) {
+        std::cout << desc << std::endl;;
+        throw "";
+    }
+    return parameters;
+}
+
+MemeticAlgorithmOptionalParameters read_memeticalgorithm_args(const std::vector<char*>& argv)
+{
+    MemeticAlgorithmOptionalParameters parameters;
+    po::options_description desc("Allowed options");
+    desc.add_options()
+        ("threads,t", po::value<Counter>(&parameters.thread_number), "")
+        ("iteration-limit,i", po::value<Counter>(&parameters.iteration_limit), "")
+        ("population-size,p", po::value<Counter>(&parameters.population_size), "")
+        ("local-search-iteration-limit", po::value<Counter>(&parameters.local_search_iteration_limit), "")
+        ("local-search-initial-penalty", po::value<PCost>(&parameters.local_search_initial_penalty), "")
+        ;
+    po::variables_map vm;
+    po::store(po::parse_command_line((Counter)argv.size(), argv.data(), desc), vm);
+    try {
+        po::notify(vm);
+    } catch (const po::required_option& e) {
+        std::cout << desc << std::endl;;
+        throw "";
+    }
+    return parameters;
+}
+
+GreedyPortfolioOptionalParameters read_greedyportfolio_args(const std::vector<char*>& argv)
+{
+    GreedyPortfolioOptionalParameters parameters;
+    po::options_description desc("Allowed options");
+    desc.add_options()
+        ("threads,t", po::value<Counter>(&parameters.thread_number), "")
+        (",f", po::value<std::vector<std::string>>(&parameters.desirabilities)->multitoken(), "")
+        ;
+    po::variables_map vm;
+    po::store(po::parse_command_line((Counter)argv.size(), argv.data(), desc), vm);
+    try {
+        po::notify(vm);
+    } catch (const po::required_option& e) {
+        std::cout << desc << std::endl;;
+        throw "";
+    }
+    return parameters;
+}
+
+GraspOptionalParameters read_grasp_args(const std::vector<char*>& argv)
+{
+    GraspOptionalParameters parameters;
+    po::options_description desc("Allowed options");
+    desc.add_options()
+        ("threads,t", po::value<Counter>(&parameters.thread_number), "")
+        ("iteration-limit,i", po::value<Counter>(&parameters.iteration_limit), "")
+        (",f", po::value<std::string>(&parameters.desirability), "")
+        ("no-regret", "")
+        ("alpha,a", po::value<double>(&parameters.alpha), "")
+        ("local-search-iteration-limit", po::value<Counter>(&parameters.local_search_iteration_limit), "")
+        ("local-search-initial-penalty", po::value<PCost>(&parameters.local_search_initial_penalty), "")
+        ;
+    po::variables_map vm;
+    po::store(po::parse_command_line((Counter)argv.size(), argv.data(), desc), vm);
+    try {
+        po::notify(vm);
+    } catch (const po::required_option& e) {
+        std::cout << desc << std::endl;;
+        throw "";
+    }
+    if (vm.count("no-regret"))
+        parameters.regret = false;
+    return parameters;
+}
+
 RepairOptionalParameters read_repair_args(const std::vector<char*>& argv)
 {
     RepairOptionalParameters parameters;
@@ -233,6 +410,10 @@ Output generalizedassignmentsolver::run(
         std::string desirability_string = read_desiralibity_args(algorithm_argv);
         std::unique_ptr<Desirability> f = desirability(desirability_string, instance);
         return mthgregret(instance, *f, info);
+    } else if (algorithm_args[0] == "greedyportfolio") {
+        GreedyPortfolioOptionalParameters parameters = read_greedyportfolio_args(algorithm_argv);
+        parameters.info = info;
+        return greedyportfolio(instance, parameters);
     } else if (algorithm_args[0] == "repair") {
         RepairOptionalParameters parameters = read_repair_args(algorithm_argv);
         parameters.info = info;
@@ -242,6 +423,36 @@ Output generalizedassignmentsolver::run(
         parameters.info = info;
         parameters.initial_solution = &initial_solution;
         return localsearch(instance, generator, parameters);
+    } else if (algorithm_args[0] == "penaltylocalsearch") {
+        PenaltyLocalSearchOptionalParameters parameters = read_penaltylocalsearch_args(algorithm_argv);
+        parameters.info = info;
+        parameters.initial_solution = &initial_solution;
+        return penaltylocalsearch(instance, generator, parameters);
+    } else if (algorithm_args[0] == "tabusearch") {
+        TabuSearchOptionalParameters parameters = read_tabusearch_args(algorithm_argv);
+        parameters.info = info;
+        parameters.initial_solution = &initial_solution;
+        return tabusearch(instance, generator, parameters);
+    } else if (algorithm_args[0] == "pathrelinking") {
+        PathRelinkingOptionalParameters parameters = read_pathrelinking_args(algorithm_argv);
+        parameters.info = info;
+        parameters.initial_solution = &initial_solution;
+        return pathrelinking(instance, generator, parameters);
+    } else if (algorithm_args[0] == "largeneighborhoodsearch") {
+        LargeNeighborhoodSearchOptionalParameters parameters = read_largeneighborhoodsearch_args(algorithm_argv);
+        parameters.info = info;
+        parameters.initial_solution = &initial_solution;
+        return largeneighborhoodsearch(instance, generator, parameters);
+    } else if (algorithm_args[0] == "memeticalgorithm") {
+        MemeticAlgorithmOptionalParameters parameters = read_memeticalgorithm_args(algorithm_argv);
+        parameters.info = info;
+        parameters.initial_solution = &initial_solution;
+        return memeticalgorithm(instance, generator, parameters);
+    } else if (algorithm_args[0] == "grasp") {
+        GraspOptionalParameters parameters = read_grasp_args(algorithm_argv);
+        parameters.info = info;
+        parameters.initial_solution = &initial_solution;
+        return grasp(instance, generator, parameters);
 #if LOCALocalSearchOLVER_FOUND
     } else if (algorithm_args[0] == "localsolver") {
         LocalSolverOptionalParameters parameters;
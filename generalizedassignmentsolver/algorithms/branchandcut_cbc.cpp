@@ -148,6 +148,10 @@ CoinLP::CoinLP(const Instance& instance)
     int col_number = m * n;
     col_lower.resize(col_number, 0);
     col_upper.resize(col_number, 1);
+    for (ItemIdx j = 0; j < n; ++j)
+        for (AgentIdx i = 0; i < m; ++i)
+            if (!instance.eligible(j, i))
+                col_upper[m * j + i] = 0;
 
     // Objective
     objective = std::vector<double>(col_number);
@@ -221,6 +225,18 @@ BranchAndCutCbcOutput generalizedassignmentsolver::branchandcut_cbc(
 
     CoinLP mat(instance);
 
+    // Fixed variables
+    if (parameters.fixed_alt != NULL) {
+        for (ItemIdx j = 0; j < n; ++j) {
+            for (AgentIdx i = 0; i < m; ++i) {
+                if ((*parameters.fixed_alt)[j][i] == 0)
+                    mat.col_upper[m * j + i] = 0;
+                if ((*parameters.fixed_alt)[j][i] == 1)
+                    mat.col_lower[m * j + i] = 1;
+            }
+        }
+    }
+
     OsiCbcSolverInterface solver1;
 
     // Reduce printout
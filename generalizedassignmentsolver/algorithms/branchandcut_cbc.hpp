@@ -30,6 +30,7 @@ struct BranchAndCutCbcOptionalParameters
     Info info = Info();
 
     const Solution* initial_solution = NULL;
+    const std::vector<std::vector<int>>* fixed_alt = NULL; // -1: unfixed, 0: fixed to 0, 1: fixed to 1.
     bool stop_at_first_improvment = false;
 };
 
@@ -65,6 +65,18 @@ BranchAndCutCplexOutput generalizedassignmentsolver::branchandcut_cplex(
     for (ItemIdx j = 0; j < n; j++)
         x.push_back(IloNumVarArray(env, m, 0, 1, ILOBOOL));
 
+    // Fixed variables
+    if (parameters.fixed_alt != NULL) {
+        for (ItemIdx j = 0; j < n; j++) {
+            for (AgentIdx i = 0; i < m; i++) {
+                if ((*parameters.fixed_alt)[j][i] == 0)
+                    x[j][i].setUB(0);
+                if ((*parameters.fixed_alt)[j][i] == 1)
+                    x[j][i].setLB(1);
+            }
+        }
+    }
+
     // Objective
     IloExpr expr(env);
     for (ItemIdx j = 0; j < n; j++)
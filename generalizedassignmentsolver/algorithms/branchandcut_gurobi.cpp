@@ -81,6 +81,18 @@ BranchAndCutGurobiOutput generalizedassignmentsolver::branchandcut_gurobi(
     for (ItemIdx j = 0; j < n; j++)
         x.push_back(model.addVars(m, GRB_BINARY));
 
+    // Fixed variables
+    if (parameters.fixed_alt != NULL) {
+        for (ItemIdx j = 0; j < n; j++) {
+            for (AgentIdx i = 0; i < m; i++) {
+                if ((*parameters.fixed_alt)[j][i] == 0)
+                    x[j][i].set(GRB_DoubleAttr_UB, 0);
+                if ((*parameters.fixed_alt)[j][i] == 1)
+                    x[j][i].set(GRB_DoubleAttr_LB, 1);
+            }
+        }
+    }
+
     // Objective
     for (ItemIdx j = 0; j < n; j++)
         for (AgentIdx i = 0; i < m; i++)
@@ -12,6 +12,7 @@ struct BranchAndCutGurobiOptionalParameters
     Info info = Info();
 
     const Solution* initial_solution = NULL;
+    const std::vector<std::vector<int>>* fixed_alt = NULL; // -1: unfixed, 0: fixed to 0, 1: fixed to 1.
     bool only_linear_relaxation = false;
 };
 
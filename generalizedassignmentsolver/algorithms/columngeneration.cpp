@@ -171,7 +171,6 @@ std::vector<Column> PricingSolver::solve_pricing(
             const std::vector<Value>& duals)
 {
     AgentIdx m = instance_.agent_number();
-    ItemIdx n = instance_.item_number();
     std::vector<Column> columns;
     knapsacksolver::Profit mult = 10000;
     for (AgentIdx i = 0; i < instance_.agent_number(); ++i) {
@@ -181,12 +180,12 @@ std::vector<Column> PricingSolver::solve_pricing(
         knapsacksolver::Instance instance_kp;
         instance_kp.set_capacity(instance_.capacity(i));
         kp2gap_.clear();
-        for (ItemIdx j = 0; j < n; ++j) {
+        for (ItemIdx j: instance_.eligible_items(i)) {
             if (fixed_items_[j] == 1)
                 continue;
             knapsacksolver::Profit profit = std::floor(mult * duals[m + j])
                     - std::ceil(mult * instance_.cost(j, i));
-            if (profit <= 0 || instance_.weight(j, i) > instance_.capacity(i))
+            if (profit <= 0)
                 continue;
             instance_kp.add_item(instance_.weight(j, i), profit);
             kp2gap_.push_back(j);
@@ -0,0 +1,137 @@
+#include "generalizedassignmentsolver/algorithms/grasp.hpp"
+
+#include "generalizedassignmentsolver/algorithms/greedy.hpp"
+#include "generalizedassignmentsolver/algorithms/penaltylocalsearch.hpp"
+#include "generalizedassignmentsolver/algorithms/repair.hpp"
+
+#include <random>
+#include <algorithm>
+#include <vector>
+#include <thread>
+#include <mutex>
+
+using namespace generalizedassignmentsolver;
+
+GraspOutput& GraspOutput::algorithm_end(Info& info)
+{
+    PUT(info, "Algorithm", "Iterations", iterations);
+    Output::algorithm_end(info);
+    VER(info, "Iterations: " << iterations << std::endl);
+    return *this;
+}
+
+/** Build a solution and improve it. */
+Solution grasp_construction(
+        const Instance& instance,
+        const Desirability& f,
+        const std::vector<std::vector<AgentIdx>>& agents,
+        Counter it,
+        std::mt19937_64& generator,
+        const GraspOptionalParameters& parameters)
+{
+    Solution solution(instance);
+    if (it == 0) {
+        if (parameters.regret) {
+            greedyregret(solution, f, agents, {});
+        } else {
+            greedy(solution, f);
+        }
+    } else {
+        greedy_randomized(solution, f, agents, parameters.regret, parameters.alpha, generator);
+    }
+
+    // Complete the solution and repair it.
+    if (!solution.feasible()) {
+        for (ItemIdx j = 0; j < instance.item_number(); ++j)
+            if (solution.agent(j) == -1 && !agents[j].empty())
+                solution.set(j, agents[j][0]);
+        Info info_repair = Info().set_verbose(false);
+        info_repair.set_timelimit(parameters.info.remaining_time());
+        repair_shift_swap(solution, info_repair);
+    }
+
+    // An item without eligible agent cannot be assigned: the instance is
+    // infeasible and the local search would start from a solution unrelated
+    // to this construction.
+    if (!solution.full())
+        return solution;
+
+    if (parameters.local_search_iteration_limit > 0) {
+        PenaltyLocalSearchOptionalParameters parameters_local_search;
+        parameters_local_search.info.set_verbose(false);
+        parameters_local_search.info.set_timelimit(parameters.info.remaining_time());
+        parameters_local_search.iteration_limit = parameters.local_search_iteration_limit;
+        parameters_local_search.initial_penalty = parameters.local_search_initial_penalty;
+        parameters_local_search.initial_solution = &solution;
+        auto output_local_search = penaltylocalsearch(
+                instance, generator, parameters_local_search);
+        return output_local_search.solution;
+    }
+    if (solution.feasible())
+        nshift(solution);
+    return solution;
+}
+
+void grasp_worker(
+        GraspOutput& output,
+        const Desirability& f,
+        const std::vector<std::vector<AgentIdx>>& agents,
+        Seed seed,
+        GraspOptionalParameters& parameters,
+        std::mutex& mutex)
+{
+    const Instance& instance = output.solution.instance();
+    std::mt19937_64 generator(seed);
+    for (;;) {
+        Counter it = 0;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!parameters.info.check_time())
+                break;
+            if (parameters.iteration_limit != -1
+                    && output.iterations >= parameters.iteration_limit)
+                break;
+            it = output.iterations++;
+        }
+
+        Solution solution = grasp_construction(instance, f, agents, it, generator, parameters);
+        std::stringstream ss;
+        ss << "construction " << it;
+        output.update_solution(solution, ss, parameters.info);
+    }
+}
+
+GraspOutput generalizedassignmentsolver::grasp(
+        const Instance& instance,
+        std::mt19937_64& generator,
+        GraspOptionalParameters parameters)
+{
+    VER(parameters.info, "*** grasp " << parameters.desirability << " ***" << std::endl);
+    GraspOutput output(instance, parameters.info);
+    Counter thread_number = std::max((Counter)1, parameters.thread_number);
+
+    if (parameters.initial_solution != nullptr
+            && parameters.initial_solution->feasible())
+        output.update_solution(*parameters.initial_solution, std::stringstream("initial solution"), parameters.info);
+
+    std::unique_ptr<Desirability> f = desirability(parameters.desirability, instance);
+    auto agents = greedyregret_init(instance, *f);
+
+    std::mutex mutex;
+    std::vector<std::thread> threads;
+    for (Counter t = 1; t < thread_number; ++t)
+        threads.push_back(std::thread(
+                    grasp_worker,
+                    std::ref(output),
+                    std::cref(*f),
+                    std::cref(agents),
+                    generator(),
+                    std::ref(parameters),
+                    std::ref(mutex)));
+    grasp_worker(output, *f, agents, generator(), parameters, mutex);
+    for (std::thread& thread: threads)
+        thread.join();
+
+    return output.algorithm_end(parameters.info);
+}
+
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "generalizedassignmentsolver/solution.hpp"
+
+namespace generalizedassignmentsolver
+{
+
+struct GraspOptionalParameters
+{
+    Info info = Info();
+
+    Counter thread_number = 1;
+    /** Maximum number of constructions; -1 for no limit. */
+    Counter iteration_limit = 100;
+    std::string desirability = "cij";
+    /**
+     * Select the items by regret as in greedyregret instead of by
+     * desirability as in greedy.
+     */
+    bool regret = true;
+    /** Size of the restricted candidate lists, from 0 (greedy) to 1 (random). */
+    double alpha = 0.1;
+    /**
+     * Iteration limit of the penaltylocalsearch improving each construction;
+     * 0 to only improve it with nshift.
+     */
+    Counter local_search_iteration_limit = 0;
+    /** Initial penalty of a unit of overcapacity in these local searches. */
+    PCost local_search_initial_penalty = 30;
+    const Solution* initial_solution = nullptr;
+};
+
+struct GraspOutput: Output
+{
+    GraspOutput(const Instance& instance, Info& info): Output(instance, info) { }
+    GraspOutput& algorithm_end(Info& info);
+
+    Counter iterations = 0;
+};
+
+/**
+ * Greedy randomized adaptive search procedure.
+ *
+ * Each construction is built with greedy_randomized, then improved with
+ * nshift or with penaltylocalsearch. The first construction is the
+ * deterministic greedy or greedyregret. Constructions which are not
+ * feasible are completed and repaired with repair_shift_swap.
+ *
+ * The constructions are independent: thread_number threads build them in
+ * parallel, each with its own generator.
+ */
+GraspOutput grasp(
+        const Instance& instance,
+        std::mt19937_64& generator,
+        GraspOptionalParameters parameters = {});
+
+}
+
@@ -4,125 +4,616 @@
 #include <random>
 #include <algorithm>
 #include <vector>
+#include <functional>
+#include <thread>
+#include <atomic>
+#include <mutex>
 
 using namespace generalizedassignmentsolver;
 
-std::vector<std::pair<ItemIdx, AgentIdx>> generalizedassignmentsolver::greedy_init(const Solution& solution, const Desirability& f)
+/**
+ * Eligible alternatives of the unassigned items of a solution, by increasing
+ * desirability, ties broken by item then by agent.
+ *
+ * Only the best remaining alternative of each item is stored in a heap. The
+ * alternatives of an item are only sorted when its best alternative is
+ * rejected, and the alternatives of an assigned item are dropped. Thus, the
+ * cost of the greedy depends on the alternatives it actually considers
+ * instead of the n x m alternatives. If the sorted alternatives of the items
+ * are given, as computed by greedyregret_init, they are used instead.
+ */
+template <typename F>
+class GreedyAlternatives
 {
-    const Instance& instance = solution.instance();
-    ItemIdx  n = instance.item_number();
-    AgentIdx m = instance.agent_number();
-    std::vector<std::pair<ItemIdx, AgentIdx>> alt;
-    for (ItemIdx j = 0; j < n; ++j)
-        for (AgentIdx i = 0; i < m; ++i)
-            alt.push_back({j, i});
-    sort(alt.begin(), alt.end(), [&f](
-                const std::pair<ItemIdx, AgentIdx>& a,
-                const std::pair<ItemIdx, AgentIdx>& b) -> bool {
-            return f(a.first, a.second) < f(b.first, b.second); });
-    return alt;
-}
 
-void generalizedassignmentsolver::greedy(Solution& solution, const std::vector<std::pair<ItemIdx, AgentIdx>>& alt)
+public:
+
+    struct Alternative
+    {
+        double value;
+        ItemIdx j;
+        AgentIdx i;
+
+        bool operator>(const Alternative& alternative) const
+        {
+            if (value != alternative.value)
+                return value > alternative.value;
+            if (j != alternative.j)
+                return j > alternative.j;
+            return i > alternative.i;
+        }
+    };
+
+    GreedyAlternatives(const Solution& solution, const F& f,
+            const std::vector<std::vector<AgentIdx>>* agents):
+        instance_(solution.instance()),
+        f_(f),
+        agents_(agents),
+        sorted_agents_(instance_.item_number()),
+        sorted_(instance_.item_number(), 0)
+    {
+        if (agents_ != nullptr)
+            positions_.resize(instance_.item_number(), 0);
+        for (ItemIdx j = 0; j < instance_.item_number(); ++j) {
+            if (solution.agent(j) != -1)
+                continue;
+            if (agents_ != nullptr) {
+                if (!(*agents_)[j].empty()) {
+                    AgentIdx i = (*agents_)[j][0];
+                    heap_.push_back({f_(j, i), j, i});
+                }
+                continue;
+            }
+            Alternative alternative_best = {0, -1, -1};
+            for (AgentIdx i: instance_.eligible_agents(j)) {
+                Alternative alternative = {f_(j, i), j, i};
+                if (alternative_best.i == -1 || alternative_best > alternative)
+                    alternative_best = alternative;
+            }
+            if (alternative_best.i != -1)
+                heap_.push_back(alternative_best);
+        }
+        std::make_heap(heap_.begin(), heap_.end(), std::greater<Alternative>());
+    }
+
+    inline bool empty() const { return heap_.empty(); }
+    /** Best remaining alternative. */
+    inline const Alternative& top() const { return heap_.front(); }
+
+    /** Replace the best alternative by the next alternative of its item. */
+    void reject()
+    {
+        ItemIdx j = top().j;
+        pop();
+        if (agents_ != nullptr) {
+            AgentPos pos = ++positions_[j];
+            if (pos == (AgentPos)(*agents_)[j].size())
+                return;
+            AgentIdx i = (*agents_)[j][pos];
+            heap_.push_back({f_(j, i), j, i});
+            std::push_heap(heap_.begin(), heap_.end(), std::greater<Alternative>());
+            return;
+        }
+        std::vector<Alternative>& agents = sorted_agents_[j];
+        if (!sorted_[j]) {
+            sorted_[j] = 1;
+            for (AgentIdx i: instance_.eligible_agents(j))
+                agents.push_back({f_(j, i), j, i});
+            std::sort(agents.begin(), agents.end(), std::greater<Alternative>());
+            agents.pop_back();
+        }
+        if (agents.empty())
+            return;
+        heap_.push_back(agents.back());
+        agents.pop_back();
+        std::push_heap(heap_.begin(), heap_.end(), std::greater<Alternative>());
+    }
+
+    /** Remove the best alternative and the other alternatives of its item. */
+    void accept()
+    {
+        ItemIdx j = top().j;
+        pop();
+        if (agents_ == nullptr)
+            std::vector<Alternative>().swap(sorted_agents_[j]);
+    }
+
+private:
+
+    inline void pop()
+    {
+        std::pop_heap(heap_.begin(), heap_.end(), std::greater<Alternative>());
+        heap_.pop_back();
+    }
+
+    const Instance& instance_;
+    const F& f_;
+    /** Sorted alternatives of the items, nullptr if they are sorted lazily. */
+    const std::vector<std::vector<AgentIdx>>* agents_;
+    /** positions_[j]: position of the best alternative of j in (*agents_)[j]. */
+    std::vector<AgentPos> positions_;
+    /** Min-heap of the best remaining alternative of each unassigned item. */
+    std::vector<Alternative> heap_;
+    /**
+     * sorted_agents_[j]: remaining alternatives of item j by decreasing
+     * desirability; built when the first alternative of j is rejected.
+     */
+    std::vector<std::vector<Alternative>> sorted_agents_;
+    std::vector<int8_t> sorted_;
+
+};
+
+template <typename F>
+void greedy_kernel(Solution& solution, const F& f,
+        const std::vector<std::vector<AgentIdx>>* agents)
 {
     const Instance& instance = solution.instance();
-    for (auto p: alt) {
-        ItemIdx j = p.first;
-        if (solution.agent(j) != -1)
-            continue;
-        AgentIdx i = p.second;
-        if (solution.remaining_capacity(i) < instance.weight(j, i))
+    GreedyAlternatives<F> alternatives(solution, f, agents);
+    while (!alternatives.empty() && !solution.full()) {
+        ItemIdx j = alternatives.top().j;
+        AgentIdx i = alternatives.top().i;
+        if (solution.remaining_capacity(i) < instance.weight(j, i)) {
+            alternatives.reject();
             continue;
+        }
         solution.set(j, i);
-        if (solution.full())
-            break;
+        alternatives.accept();
     }
 }
 
+void generalizedassignmentsolver::greedy(Solution& solution, const Desirability& f)
+{
+    desirability_dispatch(f, [&solution](const auto& g)
+    {
+        greedy_kernel(solution, g, nullptr);
+    });
+}
+
+void generalizedassignmentsolver::greedy(Solution& solution, const Desirability& f,
+        const std::vector<std::vector<AgentIdx>>& agents)
+{
+    desirability_dispatch(f, [&solution, &agents](const auto& g)
+    {
+        greedy_kernel(solution, g, &agents);
+    });
+}
+
 Output generalizedassignmentsolver::greedy(const Instance& instance, const Desirability& f, Info info)
 {
     VER(info, "*** greedy " << f.to_string() << " ***" << std::endl);
     Output output(instance, info);
     Solution solution(instance);
-    auto alt = greedy_init(solution, f);
-    greedy(solution, alt);
+    greedy(solution, f);
     output.update_solution(solution, std::stringstream(""), info);
     return output.algorithm_end(info);
 }
 
 /******************************************************************************/
 
-std::vector<std::vector<AgentIdx>> generalizedassignmentsolver::greedyregret_init(const Instance& instance, const Desirability& f)
+std::vector<std::vector<AgentIdx>> generalizedassignmentsolver::greedyregret_init(const Instance& instance, const Desirability& f_virtual)
 {
     ItemIdx n = instance.item_number();
-    AgentIdx m = instance.agent_number();
+    DesirabilityMatrix f(instance, f_virtual);
 
-    std::vector<std::vector<AgentIdx>> agents(n, std::vector<AgentIdx>(m));
+    std::vector<std::vector<AgentIdx>> agents(n);
     for (ItemIdx j = 0; j < n; ++j) {
-        std::iota(agents[j].begin(), agents[j].end(), 0);
+        auto eligible_agents = instance.eligible_agents(j);
+        agents[j].assign(eligible_agents.begin(), eligible_agents.end());
         sort(agents[j].begin(), agents[j].end(), [&f, &j](
                     AgentIdx i1, AgentIdx i2) -> bool {
-                return f(j, i1) < f(j, i2); });
+                if (f(j, i1) != f(j, i2))
+                    return f(j, i1) < f(j, i2);
+                return i1 < i2; });
     }
 
     return agents;
 }
 
-void generalizedassignmentsolver::greedyregret(Solution& solution, const Desirability& f,
+/**
+ * Indexed max-heap of the unassigned items by regret; ties are broken by
+ * smallest item index.
+ */
+class GreedyRegretQueue
+{
+
+public:
+
+    GreedyRegretQueue(ItemIdx n): positions_(n, -1), regrets_(n, 0) { }
+
+    inline bool empty() const { return heap_.empty(); }
+
+    /** Insert item j or update its regret. */
+    void update(ItemIdx j, double regret)
+    {
+        if (positions_[j] == -1) {
+            positions_[j] = heap_.size();
+            heap_.push_back(j);
+            regrets_[j] = regret;
+            sift_up(positions_[j]);
+        } else {
+            double regret_old = regrets_[j];
+            regrets_[j] = regret;
+            if (regret_old < regret) {
+                sift_up(positions_[j]);
+            } else {
+                sift_down(positions_[j]);
+            }
+        }
+    }
+
+    /** Remove the item with the largest regret and return it. */
+    ItemIdx pop()
+    {
+        ItemIdx j = heap_.front();
+        positions_[j] = -1;
+        if (heap_.size() == 1) {
+            heap_.pop_back();
+            return j;
+        }
+        heap_.front() = heap_.back();
+        heap_.pop_back();
+        positions_[heap_.front()] = 0;
+        sift_down(0);
+        return j;
+    }
+
+private:
+
+    inline bool better(ItemIdx j1, ItemIdx j2) const
+    {
+        if (regrets_[j1] != regrets_[j2])
+            return regrets_[j1] > regrets_[j2];
+        return j1 < j2;
+    }
+
+    inline void swap(ItemPos pos_1, ItemPos pos_2)
+    {
+        std::swap(heap_[pos_1], heap_[pos_2]);
+        positions_[heap_[pos_1]] = pos_1;
+        positions_[heap_[pos_2]] = pos_2;
+    }
+
+    void sift_up(ItemPos pos)
+    {
+        while (pos > 0) {
+            ItemPos pos_parent = (pos - 1) / 2;
+            if (!better(heap_[pos], heap_[pos_parent]))
+                break;
+            swap(pos, pos_parent);
+            pos = pos_parent;
+        }
+    }
+
+    void sift_down(ItemPos pos)
+    {
+        ItemPos size = heap_.size();
+        for (;;) {
+            ItemPos pos_best = pos;
+            for (ItemPos pos_child = 2 * pos + 1; pos_child <= 2 * pos + 2 && pos_child < size; ++pos_child)
+                if (better(heap_[pos_child], heap_[pos_best]))
+                    pos_best = pos_child;
+            if (pos_best == pos)
+                break;
+            swap(pos, pos_best);
+            pos = pos_best;
+        }
+    }
+
+    std::vector<ItemIdx> heap_;
+    /** positions_[j]: position of item j in heap_, -1 if it is not in it. */
+    std::vector<ItemPos> positions_;
+    std::vector<double> regrets_;
+
+};
+
+/**
+ * Unassigned items of a randomized greedy: the next item is drawn uniformly
+ * among the restricted candidate list of the items whose key is at least
+ * k_max - alpha (k_max - k_min).
+ *
+ * The items are stored in a treap ordered by key, ties broken by item index,
+ * whose nodes store the size of their subtree. Thus, the size of the
+ * restricted candidate list and its k-th item are found in O(log n) expected
+ * time, instead of being enumerated. Node j is item j.
+ */
+class GreedyRandomizedQueue
+{
+
+public:
+
+    GreedyRandomizedQueue(ItemIdx n, double alpha, std::mt19937_64& generator):
+        keys_(n, 0),
+        priorities_(n),
+        children_(n, {-1, -1}),
+        sizes_(n, 0),
+        alpha_(alpha),
+        generator_(generator)
+    {
+        // The priorities don't use generator, so that the drawn items only
+        // depend on the keys.
+        std::mt19937 generator_priorities(0);
+        for (ItemIdx j = 0; j < n; ++j)
+            priorities_[j] = generator_priorities();
+    }
+
+    inline bool empty() const { return root_ == -1; }
+
+    /** Insert item j or update its key. */
+    void update(ItemIdx j, double key)
+    {
+        if (sizes_[j] != 0)
+            root_ = erase(root_, j);
+        keys_[j] = key;
+        children_[j] = {-1, -1};
+        sizes_[j] = 1;
+        ItemIdx left = -1;
+        ItemIdx right = -1;
+        split(root_, j, left, right);
+        root_ = merge(merge(left, j), right);
+    }
+
+    /** Remove a random item of the restricted candidate list and return it. */
+    ItemIdx pop()
+    {
+        double key_min = keys_[extremity(0)];
+        double key_max = keys_[extremity(1)];
+        double threshold = (key_max == std::numeric_limits<double>::infinity())?
+            key_max: key_max - alpha_ * (key_max - key_min);
+
+        // Size of the restricted candidate list.
+        ItemPos size = 0;
+        for (ItemIdx j = root_; j != -1;) {
+            if (keys_[j] >= threshold) {
+                size += size_of(children_[j].second) + 1;
+                j = children_[j].first;
+            } else {
+                j = children_[j].second;
+            }
+        }
+
+        // Draw its k-th largest item.
+        std::uniform_int_distribution<ItemPos> d(1, size);
+        ItemPos k = d(generator_);
+        ItemIdx j = root_;
+        for (;;) {
+            ItemPos size_right = size_of(children_[j].second);
+            if (k <= size_right) {
+                j = children_[j].second;
+            } else if (k == size_right + 1) {
+                break;
+            } else {
+                k -= size_right + 1;
+                j = children_[j].first;
+            }
+        }
+        root_ = erase(root_, j);
+        sizes_[j] = 0;
+        return j;
+    }
+
+private:
+
+    inline ItemPos size_of(ItemIdx j) const { return (j == -1)? 0: sizes_[j]; }
+
+    inline bool less(ItemIdx j1, ItemIdx j2) const
+    {
+        if (keys_[j1] != keys_[j2])
+            return keys_[j1] < keys_[j2];
+        return j1 < j2;
+    }
+
+    inline void update_size(ItemIdx j)
+    {
+        sizes_[j] = size_of(children_[j].first) + size_of(children_[j].second) + 1;
+    }
+
+    /** Item with the smallest key if side is 0, the largest if it is 1. */
+    ItemIdx extremity(int side) const
+    {
+        ItemIdx j = root_;
+        for (;;) {
+            ItemIdx j_next = (side == 0)? children_[j].first: children_[j].second;
+            if (j_next == -1)
+                return j;
+            j = j_next;
+        }
+    }
+
+    /** Split the subtree of j into the items before and after item j0. */
+    void split(ItemIdx j, ItemIdx j0, ItemIdx& left, ItemIdx& right)
+    {
+        if (j == -1) {
+            left = -1;
+            right = -1;
+        } else if (less(j, j0)) {
+            split(children_[j].second, j0, children_[j].second, right);
+            left = j;
+            update_size(j);
+        } else {
+            split(children_[j].first, j0, left, children_[j].first);
+            right = j;
+            update_size(j);
+        }
+    }
+
+    /** Merge two subtrees, the items of left being before those of right. */
+    ItemIdx merge(ItemIdx left, ItemIdx right)
+    {
+        if (left == -1)
+            return right;
+        if (right == -1)
+            return left;
+        if (priorities_[left] > priorities_[right]) {
+            children_[left].second = merge(children_[left].second, right);
+            update_size(left);
+            return left;
+        } else {
+            children_[right].first = merge(left, children_[right].first);
+            update_size(right);
+            return right;
+        }
+    }
+
+    /** Remove item j0 from the subtree of j and return its new root. */
+    ItemIdx erase(ItemIdx j, ItemIdx j0)
+    {
+        if (j == j0)
+            return merge(children_[j].first, children_[j].second);
+        if (less(j0, j)) {
+            children_[j].first = erase(children_[j].first, j0);
+        } else {
+            children_[j].second = erase(children_[j].second, j0);
+        }
+        update_size(j);
+        return j;
+    }
+
+    std::vector<double> keys_;
+    std::vector<uint32_t> priorities_;
+    /** children_[j]: left and right children of item j, -1 if none. */
+    std::vector<std::pair<ItemIdx, ItemIdx>> children_;
+    /** sizes_[j]: size of the subtree of item j, 0 if it is not in the queue. */
+    std::vector<ItemPos> sizes_;
+    ItemIdx root_ = -1;
+    double alpha_;
+    std::mt19937_64& generator_;
+
+};
+
+/**
+ * Assign the items taken from queue to their best agent. The key of an item
+ * is its regret, or, if regret is false, minus the desirability of its best
+ * agent.
+ *
+ * The key of an item only depends on its first and second best agents which
+ * can still receive it. After assigning an item to agent i, only the items
+ * whose first or second best agent is i are updated; they are found in the
+ * watch list of agent i.
+ */
+template <typename F, typename Queue>
+void greedyregret_kernel(Solution& solution, const F& f,
         const std::vector<std::vector<AgentIdx>>& agents,
-        const std::vector<std::vector<int>>& fixed_alt)
+        const std::vector<std::vector<int>>& fixed_alt,
+        bool regret,
+        Queue& queue)
 {
     const Instance& instance = solution.instance();
     ItemIdx n = instance.item_number();
-    AgentIdx m = instance.agent_number();
-    std::vector<std::pair<AgentIdx, AgentIdx>> bests(n, {0, 1});
+    std::vector<std::pair<AgentPos, AgentPos>> bests(n, {0, 1});
+    std::vector<std::vector<ItemIdx>> watch_lists(instance.agent_number());
+    std::vector<Counter> stamps(n, -1);
 
-    while (!solution.full()) {
-        ItemIdx j_best = -1;
-        double f_best = -1;
-        for (ItemIdx j = 0; j < n; ++j) {
-            if (solution.agent(j) != -1)
-                continue;
+    // Move the first and second best agents of item j to the next agents
+    // which can receive it, and update its key if they changed. Return false
+    // if no agent can receive it.
+    auto update = [&](ItemIdx j, bool inserted)
+    {
+        auto bests_old = bests[j];
+        AgentPos& i_first = bests[j].first;
+        AgentPos& i_second = bests[j].second;
+        AgentPos m = agents[j].size();
 
-            AgentIdx& i_first = bests[j].first;
-            AgentIdx& i_second = bests[j].second;
-
-            while (i_first < m) {
-                AgentIdx i = agents[j][i_first];
-                if (instance.weight(j, i) > solution.remaining_capacity(i) ||
-                        (!fixed_alt.empty() && fixed_alt[j][i] != -1)) {
-                    i_first++;
-                    if (i_first == i_second)
-                        i_second++;
-                } else {
-                    break;
-                }
+        while (i_first < m) {
+            AgentIdx i = agents[j][i_first];
+            if (instance.weight(j, i) > solution.remaining_capacity(i) ||
+                    (!fixed_alt.empty() && fixed_alt[j][i] == 0)) {
+                i_first++;
+                if (i_first == i_second)
+                    i_second++;
+            } else {
+                break;
             }
-            if (i_first == m)
-                return;
+        }
+        if (i_first == m)
+            return false;
 
-            while (i_second < m) {
-                AgentIdx i = agents[j][i_second];
-                if (instance.weight(j, i) > solution.remaining_capacity(i) ||
-                        (!fixed_alt.empty() && fixed_alt[j][i] != -1)) {
-                    i_second++;
-                } else {
-                    break;
-                }
+        while (i_second < m) {
+            AgentIdx i = agents[j][i_second];
+            if (instance.weight(j, i) > solution.remaining_capacity(i) ||
+                    (!fixed_alt.empty() && fixed_alt[j][i] == 0)) {
+                i_second++;
+            } else {
+                break;
             }
+        }
+
+        if (inserted && bests[j] == bests_old)
+            return true;
+        if (!regret) {
+            queue.update(j, -f(j, agents[j][i_first]));
+        } else if (i_second == m) {
+            queue.update(j, std::numeric_limits<double>::infinity());
+        } else {
+            queue.update(j, f(j, agents[j][i_second]) - f(j, agents[j][i_first]));
+        }
+        return true;
+    };
+    auto watch = [&](ItemIdx j)
+    {
+        watch_lists[agents[j][bests[j].first]].push_back(j);
+        if (bests[j].second < (AgentPos)agents[j].size())
+            watch_lists[agents[j][bests[j].second]].push_back(j);
+    };
+
+    for (ItemIdx j = 0; j < n; ++j) {
+        if (solution.agent(j) != -1)
+            continue;
+        if (!update(j, false))
+            return;
+        watch(j);
+    }
+
+    for (Counter it = 0; !queue.empty(); ++it) {
+        ItemIdx j_best = queue.pop();
+        AgentIdx i_best = agents[j_best][bests[j_best].first];
+        solution.set(j_best, i_best);
 
-            double f_curr = (i_second == m)?
-                std::numeric_limits<double>::infinity():
-                f(j, agents[j][i_second]) - f(j, agents[j][i_first]);
-            if (j_best == -1 || f_best < f_curr) {
-                f_best = f_curr;
-                j_best = j;
+        // Update the items watching agent i_best. The items which don't
+        // reference it anymore are removed from its watch list.
+        std::vector<ItemIdx> watch_list;
+        watch_list.swap(watch_lists[i_best]);
+        for (ItemIdx j: watch_list) {
+            if (solution.agent(j) != -1 || stamps[j] == it)
+                continue;
+            stamps[j] = it;
+            auto bests_old = bests[j];
+            if (!update(j, true))
+                return;
+            if (bests[j] != bests_old) {
+                watch(j);
+            } else if (agents[j][bests[j].first] == i_best
+                    || (bests[j].second < (AgentPos)agents[j].size()
+                        && agents[j][bests[j].second] == i_best)) {
+                watch_lists[i_best].push_back(j);
             }
         }
-        solution.set(j_best, agents[j_best][bests[j_best].first]);
     }
 }
 
+void generalizedassignmentsolver::greedyregret(Solution& solution, const Desirability& f,
+        const std::vector<std::vector<AgentIdx>>& agents,
+        const std::vector<std::vector<int>>& fixed_alt)
+{
+    desirability_dispatch(f, [&solution, &agents, &fixed_alt](const auto& g)
+    {
+        GreedyRegretQueue queue(solution.instance().item_number());
+        greedyregret_kernel(solution, g, agents, fixed_alt, true, queue);
+    });
+}
+
+void generalizedassignmentsolver::greedy_randomized(Solution& solution, const Desirability& f,
+        const std::vector<std::vector<AgentIdx>>& agents,
+        bool regret,
+        double alpha,
+        std::mt19937_64& generator)
+{
+    desirability_dispatch(f, [&solution, &agents, regret, alpha, &generator](const auto& g)
+    {
+        GreedyRandomizedQueue queue(solution.instance().item_number(), alpha, generator);
+        greedyregret_kernel(solution, g, agents, {}, regret, queue);
+    });
+}
+
 Output generalizedassignmentsolver::greedyregret(const Instance& instance, const Desirability& f, Info info)
 {
     VER(info, "*** greedyregret " << f.to_string() << " ***" << std::endl);
@@ -136,16 +627,15 @@ Output generalizedassignmentsolver::greedyregret(const Instance& instance, const
 
 /******************************************************************************/
 
-void nshift(Solution& solution)
+void generalizedassignmentsolver::nshift(Solution& solution)
 {
     const Instance& instance = solution.instance();
     ItemIdx n = instance.item_number();
-    AgentIdx m = instance.agent_number();
     for (ItemIdx j = 0; j < n; ++j) {
         AgentIdx i_old = solution.agent(j);
         Cost c_best = 0;
         AgentIdx i_best = -1;
-        for (AgentIdx i = 0; i < m; ++i) {
+        for (AgentIdx i: instance.candidate_agents(j)) {
             if (i == i_old)
                 continue;
             if (solution.remaining_capacity(i) >= instance.weight(j, i)
@@ -159,9 +649,9 @@ void nshift(Solution& solution)
     }
 }
 
-void generalizedassignmentsolver::mthg(Solution& solution, const std::vector<std::pair<ItemIdx, AgentIdx>>& alt)
+void generalizedassignmentsolver::mthg(Solution& solution, const Desirability& f)
 {
-    greedy(solution, alt);
+    greedy(solution, f);
     if (solution.feasible())
         nshift(solution);
 }
@@ -171,8 +661,7 @@ Output generalizedassignmentsolver::mthg(const Instance& instance, const Desirab
     VER(info, "*** mthg " << f.to_string() << " ***" << std::endl);
     Output output(instance, info);
     Solution solution(instance);
-    auto alt = greedy_init(solution, f);
-    mthg(solution, alt);
+    mthg(solution, f);
     output.update_solution(solution, std::stringstream(""), info);
     return output.algorithm_end(info);
 }
@@ -197,3 +686,81 @@ Output generalizedassignmentsolver::mthgregret(const Instance& instance, const D
     return output.algorithm_end(info);
 }
 
+/******************************************************************************/
+
+GreedyPortfolioOutput& GreedyPortfolioOutput::algorithm_end(Info& info)
+{
+    for (Counter pos = 0; pos < (Counter)labels.size(); ++pos)
+        PUT(info, "Algorithm", labels[pos], costs[pos]);
+    Output::algorithm_end(info);
+    for (Counter pos = 0; pos < (Counter)labels.size(); ++pos)
+        VER(info, labels[pos] << ": " << costs[pos] << std::endl);
+    return *this;
+}
+
+GreedyPortfolioOutput generalizedassignmentsolver::greedyportfolio(
+        const Instance& instance,
+        GreedyPortfolioOptionalParameters parameters)
+{
+    VER(parameters.info, "*** greedyportfolio ***" << std::endl);
+    GreedyPortfolioOutput output(instance, parameters.info);
+    Counter thread_number = std::max((Counter)1, parameters.thread_number);
+
+    // Construction k runs greedy (k even) or greedyregret (k odd) with
+    // desirability function k / 2; its results are stored at positions 2k
+    // and 2k + 1, the latter after nshift.
+    Counter construction_number = 2 * parameters.desirabilities.size();
+    for (Counter k = 0; k < construction_number; ++k) {
+        const std::string& desirability_string = parameters.desirabilities[k / 2];
+        std::string regret = (k % 2 == 1)? "regret": "";
+        output.labels.push_back("greedy" + regret + " -f " + desirability_string);
+        output.labels.push_back("mthg" + regret + " -f " + desirability_string);
+    }
+    output.costs.resize(output.labels.size(), -1);
+
+    // The desirability function and the sorted agents of desirability d are
+    // computed once, by the first construction which needs them, and shared
+    // by both constructions.
+    Counter desirability_number = parameters.desirabilities.size();
+    std::vector<std::unique_ptr<Desirability>> fs(desirability_number);
+    std::vector<std::vector<std::vector<AgentIdx>>> agents(desirability_number);
+    std::vector<std::once_flag> initialized(desirability_number);
+
+    std::atomic<Counter> k_next(0);
+    auto worker = [&instance, &parameters, &output, &k_next, construction_number,
+            &fs, &agents, &initialized]()
+    {
+        for (;;) {
+            Counter k = k_next++;
+            if (k >= construction_number || !parameters.info.check_time())
+                break;
+            Counter d = k / 2;
+            std::call_once(initialized[d], [&instance, &parameters, &fs, &agents, d]()
+            {
+                fs[d] = desirability(parameters.desirabilities[d], instance);
+                agents[d] = greedyregret_init(instance, *fs[d]);
+            });
+            Solution solution(instance);
+            if (k % 2 == 1) {
+                greedyregret(solution, *fs[d], agents[d], {});
+            } else {
+                greedy(solution, *fs[d], agents[d]);
+            }
+            for (Counter pos = 2 * k; pos <= 2 * k + 1; ++pos) {
+                if (pos == 2 * k + 1 && solution.feasible())
+                    nshift(solution);
+                if (solution.feasible())
+                    output.costs[pos] = solution.cost();
+                output.update_solution(solution, std::stringstream(output.labels[pos]), parameters.info);
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    for (Counter t = 1; t < thread_number; ++t)
+        threads.push_back(std::thread(worker));
+    worker();
+    for (std::thread& thread: threads)
+        thread.join();
+
+    return output.algorithm_end(parameters.info);
+}
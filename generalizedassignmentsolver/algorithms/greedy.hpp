@@ -6,17 +6,47 @@
 namespace generalizedassignmentsolver
 {
 
-std::vector<std::pair<ItemIdx, AgentIdx>> greedy_init(const Solution& solution, const Desirability& f);
-void greedy(Solution& solution, const std::vector<std::pair<ItemIdx, AgentIdx>>& alt);
+/**
+ * Assign the unassigned items of solution, considering the alternatives by
+ * increasing desirability.
+ */
+void greedy(Solution& solution, const Desirability& f);
 Output greedy(const Instance& instance, const Desirability& f, Info info = Info());
 
+/**
+ * Eligible agents of each item by increasing desirability, ties broken by
+ * agent index.
+ */
 std::vector<std::vector<AgentIdx>> greedyregret_init(const Instance& instance, const Desirability& f);
+/** Same as greedy, with the alternatives already sorted by greedyregret_init. */
+void greedy(Solution& solution, const Desirability& f,
+        const std::vector<std::vector<AgentIdx>>& agents);
+/** fixed_alt: empty, or fixed_alt[j][i] = -1: unfixed, 0: fixed to 0, 1: fixed to 1. */
 void greedyregret(Solution& solution, const Desirability& f,
         const std::vector<std::vector<AgentIdx>>& agents,
         const std::vector<std::vector<int>>& fixed_alt);
 Output greedyregret(const Instance& instance, const Desirability& f, Info info = Info());
 
-void mthg(Solution& solution, const std::vector<std::pair<ItemIdx, AgentIdx>>& alt);
+/**
+ * Randomized greedy: at each step, the next item is drawn at random among the
+ * items whose key is at least k_max - alpha (k_max - k_min), then it is
+ * assigned to its best agent. The key of an item is its regret as in
+ * greedyregret, or, if regret is false, minus the desirability of its best
+ * agent as in greedy. agents is computed with greedyregret_init.
+ */
+void greedy_randomized(Solution& solution, const Desirability& f,
+        const std::vector<std::vector<AgentIdx>>& agents,
+        bool regret,
+        double alpha,
+        std::mt19937_64& generator);
+
+/**
+ * Move each item, in turn, to the agent which can receive it and decreases
+ * the cost the most.
+ */
+void nshift(Solution& solution);
+
+void mthg(Solution& solution, const Desirability& f);
 Output mthg(const Instance& instance, const Desirability& f, Info info = Info());
 
 void mthgregret(Solution& instance, const Desirability& f,
@@ -24,5 +54,36 @@ void mthgregret(Solution& instance, const Desirability& f,
         const std::vector<std::vector<int>>& fixed_alt);
 Output mthgregret(const Instance& instance, const Desirability& f, Info info = Info());
 
+struct GreedyPortfolioOptionalParameters
+{
+    Info info = Info();
+
+    Counter thread_number = 1;
+    std::vector<std::string> desirabilities = {"cij", "wij", "cij*wij", "-pij/wij", "wij/ti"};
+};
+
+struct GreedyPortfolioOutput: Output
+{
+    GreedyPortfolioOutput(const Instance& instance, Info& info): Output(instance, info) { }
+    GreedyPortfolioOutput& algorithm_end(Info& info);
+
+    /** Combinations, e.g. "mthgregret -f wij". */
+    std::vector<std::string> labels;
+    /** Cost of the solution of each combination, -1 if it is not feasible. */
+    std::vector<Cost> costs;
+};
+
+/**
+ * Run greedy, greedyregret, mthg and mthgregret with each desirability
+ * function and return the best solution.
+ *
+ * mthg and mthgregret continue the solutions of greedy and greedyregret, so
+ * each desirability function leads to two constructions; they are run in
+ * parallel on thread_number threads.
+ */
+GreedyPortfolioOutput greedyportfolio(
+        const Instance& instance,
+        GreedyPortfolioOptionalParameters parameters = {});
+
 }
 
@@ -61,8 +61,22 @@ public:
 
     const column_vector der(const column_vector& x) const { (void)x; return grad_; }
 
+    /**
+     * Compute the reduced costs of the alternatives of the unfixed items for
+     * multipliers mu, see LagRelaxAssignmentLbfgsOutput::reduced_costs.
+     */
+    void compute_reduced_costs(
+            const column_vector& mu,
+            std::vector<std::vector<double>>& reduced_costs);
+
 private:
 
+    /**
+     * Build the knapsack subproblem of agent i and set kp_indices_ for its
+     * items.
+     */
+    knapsacksolver::Instance knapsack(const column_vector& mu, AgentIdx i);
+
     const Instance& instance_;
     LagRelaxAssignmentLbfgsOptionalParameters& p_;
     /** item_indices_[j] is the index of item j in mu and grad_. */
@@ -76,6 +90,33 @@ private:
 
 };
 
+knapsacksolver::Instance LagRelaxAssignmentLbfgsFunction::knapsack(
+        const column_vector& mu,
+        AgentIdx i)
+{
+    Weight mult = 10000;
+    knapsacksolver::Instance kp_instance;
+    kp_instance.set_capacity(kp_capacities_[i]);
+    knapsacksolver::ItemIdx j_kp = 0;
+    for (ItemIdx j: instance_.eligible_items(i)) {
+        if (item_indices_[j] < 0
+                || (p_.fixed_alt != NULL && (*p_.fixed_alt)[j][i] >= 0)
+                || instance_.weight(j, i) > kp_capacities_[i]) {
+            kp_indices_[j] = -1;
+            continue;
+        }
+        knapsacksolver::Profit profit = std::ceil(mult * mu(item_indices_[j]) - mult * instance_.cost(j, i));
+        if (profit <= 0) {
+            kp_indices_[j] = -1;
+            continue;
+        }
+        kp_instance.add_item(instance_.weight(j, i), profit);
+        kp_indices_[j] = j_kp;
+        j_kp++;
+    }
+    return kp_instance;
+}
+
 double LagRelaxAssignmentLbfgsFunction::f(const column_vector& mu)
 {
     ItemIdx n = instance_.item_number();
@@ -88,27 +129,9 @@ double LagRelaxAssignmentLbfgsFunction::f(const column_vector& mu)
             l += mu(item_indices_[j]);
     std::fill(grad_.begin(), grad_.end(), 1);
 
-    Weight mult = 10000;
     for (AgentIdx i = 0; i < m; ++i) {
         // Create knapsack instance
-        knapsacksolver::Instance kp_instance;
-        kp_instance.set_capacity(kp_capacities_[i]);
-        knapsacksolver::ItemIdx j_kp = 0;
-        for (ItemIdx j = 0; j < n; ++j) {
-            if ((p_.fixed_alt != NULL && (*p_.fixed_alt)[j][i] >= 0)
-                    || instance_.weight(j, i) > kp_capacities_[i]) {
-                kp_indices_[j] = -1;
-                continue;
-            }
-            knapsacksolver::Profit profit = std::ceil(mult * mu(j) - mult * instance_.cost(j, i));
-            if (profit <= 0) {
-                kp_indices_[j] = -1;
-                continue;
-            }
-            kp_instance.add_item(instance_.weight(j, i), profit);
-            kp_indices_[j] = j_kp;
-            j_kp++;
-        }
+        knapsacksolver::Instance kp_instance = knapsack(mu, i);
 
         // Solve knapsack instance
         //auto kp_output = knapsacksolver::bellman_array_all(kp_instance, Info().set_verbose(false));
@@ -116,7 +139,7 @@ double LagRelaxAssignmentLbfgsFunction::f(const column_vector& mu)
         //std::cout << "i " << i << " opt " << kp_output.solution.profit() << std::endl;
 
         // Update bound and gradient
-        for (ItemIdx j = 0; j < n; ++j) {
+        for (ItemIdx j: instance_.eligible_items(i)) {
             if (kp_indices_[j] >= 0 && kp_output.solution.contains_idx(kp_indices_[j])) {
                 grad_(item_indices_[j])--;
                 l += instance_.cost(j, i) - mu(item_indices_[j]);
@@ -127,6 +150,69 @@ double LagRelaxAssignmentLbfgsFunction::f(const column_vector& mu)
     return l;
 }
 
+void LagRelaxAssignmentLbfgsFunction::compute_reduced_costs(
+        const column_vector& mu,
+        std::vector<std::vector<double>>& reduced_costs)
+{
+    // The subproblem of agent i is a knapsack problem with profits
+    // pj = mu_j - cij. Let z be the profit of its solution, U the bound of
+    // its linear relaxation and r the efficiency of its critical item. A
+    // solution containing item j has a profit of at most
+    // U - max(0, r wij - pj), so fixing xij to 1 decreases the profit of the
+    // subproblem, hence increases the bound, by at least
+    // max(0, r wij - pj) - (U - z).
+    std::vector<ItemIdx> items;
+    for (AgentIdx i = 0; i < instance_.agent_number(); ++i) {
+        knapsacksolver::Instance kp_instance = knapsack(mu, i);
+        auto kp_output = knapsacksolver::minknap(kp_instance);
+        auto profit = [this, &mu, i](ItemIdx j)
+        {
+            return mu(item_indices_[j]) - instance_.cost(j, i);
+        };
+
+        double z = 0;
+        items.clear();
+        for (ItemIdx j: instance_.eligible_items(i)) {
+            if (kp_indices_[j] < 0)
+                continue;
+            items.push_back(j);
+            if (kp_output.solution.contains_idx(kp_indices_[j]))
+                z += profit(j);
+        }
+        std::sort(items.begin(), items.end(), [this, &profit, i](ItemIdx j1, ItemIdx j2) -> bool
+                {
+                    return profit(j1) * instance_.weight(j2, i)
+                        > profit(j2) * instance_.weight(j1, i);
+                });
+        double u = 0;
+        double r = 0;
+        Weight remaining_capacity = kp_capacities_[i];
+        for (ItemIdx j: items) {
+            if (instance_.weight(j, i) <= remaining_capacity) {
+                u += profit(j);
+                remaining_capacity -= instance_.weight(j, i);
+            } else {
+                r = profit(j) / instance_.weight(j, i);
+                u += r * remaining_capacity;
+                break;
+            }
+        }
+
+        for (ItemIdx j: instance_.eligible_items(i)) {
+            if (item_indices_[j] < 0
+                    || (p_.fixed_alt != NULL && (*p_.fixed_alt)[j][i] >= 0)
+                    || instance_.weight(j, i) > kp_capacities_[i])
+                continue;
+            if (kp_indices_[j] >= 0 && kp_output.solution.contains_idx(kp_indices_[j])) {
+                reduced_costs[j][i] = 0;
+            } else {
+                double d = std::max(0.0, r * instance_.weight(j, i) - profit(j));
+                reduced_costs[j][i] = std::max(0.0, d - (u - z));
+            }
+        }
+    }
+}
+
 LagRelaxAssignmentLbfgsOutput generalizedassignmentsolver::lagrelax_assignment_lbfgs(const Instance& instance, LagRelaxAssignmentLbfgsOptionalParameters p)
 {
     VER(p.info, "*** lagrelax_assignment_lbfgs ***" << std::endl);
@@ -161,7 +247,7 @@ LagRelaxAssignmentLbfgsOutput generalizedassignmentsolver::lagrelax_assignment_l
             if (item_indices[j] >= 0)
                 mu(item_indices[j]) = (*p.initial_multipliers)[j];
     } else {
-        for (ItemIdx j = 0; j < n; ++j)
+        for (ItemIdx j = 0; j < unfixed_item_number; ++j)
             mu(j) = 0;
     }
 
@@ -180,6 +266,7 @@ LagRelaxAssignmentLbfgsOutput generalizedassignmentsolver::lagrelax_assignment_l
             std::numeric_limits<double>::max());
 
     // Compute output parameters
+    output.value = c0 + res;
     Cost lb = c0 + std::ceil(res - TOL);
     output.update_lower_bound(lb, std::stringstream(""), p.info);
     output.multipliers.resize(n);
@@ -187,6 +274,15 @@ LagRelaxAssignmentLbfgsOutput generalizedassignmentsolver::lagrelax_assignment_l
         if (item_indices[j] >= 0)
             output.multipliers[j] = mu(item_indices[j]);
 
+    // Compute reduced costs. The alternatives fixed to 0 or which don't fit
+    // cannot be fixed to 1.
+    output.reduced_costs.resize(n, std::vector<double>(m, std::numeric_limits<double>::infinity()));
+    for (ItemIdx j = 0; j < n; ++j)
+        for (AgentIdx i = 0; i < m; ++i)
+            if (p.fixed_alt != NULL && (*p.fixed_alt)[j][i] == 1)
+                output.reduced_costs[j][i] = 0;
+    func.compute_reduced_costs(mu, output.reduced_costs);
+
     return output.algorithm_end(p.info);
 }
 
@@ -242,7 +338,7 @@ double LagRelaxKnapsackLbfgsFunction::f(const column_vector& mu)
         // Solve the trivial Generalized Upper Bound Problem
         AgentIdx i_best = -1;
         double rc_best = -1;
-        for (AgentIdx i = 0; i < m; ++i) {
+        for (AgentIdx i: instance_.eligible_agents(j)) {
             double rc = instance_.cost(j, i) - mu(i) * instance_.weight(j, i);
             if (i_best == -1
                     || rc_best > rc
@@ -258,6 +354,12 @@ double LagRelaxKnapsackLbfgsFunction::f(const column_vector& mu)
             }
         }
 
+        // Item j does not fit in any agent, the instance is infeasible.
+        if (i_best == -1) {
+            x_(j) = instance_.item(j).i_wmin;
+            continue;
+        }
+
         // Update bound and gradient
         grad_(i_best) -= instance_.weight(j, i_best);
         x_(j) = i_best;
@@ -303,6 +405,7 @@ LagRelaxKnapsackLbfgsOutput generalizedassignmentsolver::lagrelax_knapsack_lbfgs
             mu_upper);
 
     // Compute output parameters
+    output.value = res;
     Cost lb = std::ceil(res - TOL);
     output.update_lower_bound(lb, std::stringstream(""), info);
     output.multipliers.resize(m);
@@ -314,6 +417,17 @@ LagRelaxKnapsackLbfgsOutput generalizedassignmentsolver::lagrelax_knapsack_lbfgs
         output.x[j][func.agent(j)] = 1;
     }
 
+    // Compute reduced costs. The subproblem of item j is to select its
+    // alternative with minimum reduced cost cij - mu_i wij.
+    output.reduced_costs.resize(n, std::vector<double>(m, std::numeric_limits<double>::infinity()));
+    for (ItemIdx j = 0; j < n; ++j) {
+        double rc_min = std::numeric_limits<double>::infinity();
+        for (AgentIdx i: instance.eligible_agents(j))
+            rc_min = std::min(rc_min, instance.cost(j, i) - mu(i) * instance.weight(j, i));
+        for (AgentIdx i: instance.eligible_agents(j))
+            output.reduced_costs[j][i] = instance.cost(j, i) - mu(i) * instance.weight(j, i) - rc_min;
+    }
+
     return output.algorithm_end(info);
 }
 
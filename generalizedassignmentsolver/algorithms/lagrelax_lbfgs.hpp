@@ -22,6 +22,17 @@ struct LagRelaxAssignmentLbfgsOutput: Output
 
     std::vector<std::vector<double>> x; // vector of size instance.alternative_number()
     std::vector<double> multipliers; // vector of size instance.item_number()
+    /**
+     * Value of the relaxation for the multipliers, including the costs of the
+     * alternatives fixed to 1; lower_bound is this value rounded up.
+     */
+    double value = 0;
+    /**
+     * reduced_costs[j][i] is a lower bound on the increase of value when xij
+     * is fixed to 1, see reduced_cost_fixing(). It is derived from the
+     * linear relaxation of the knapsack subproblem of agent i.
+     */
+    std::vector<std::vector<double>> reduced_costs;
 };
 
 LagRelaxAssignmentLbfgsOutput lagrelax_assignment_lbfgs(const Instance& instance, LagRelaxAssignmentLbfgsOptionalParameters p = {});
@@ -35,6 +46,16 @@ struct LagRelaxKnapsackLbfgsOutput: Output
 
     std::vector<std::vector<double>> x; // vector of size instance.alternative_number()
     std::vector<double> multipliers; // vector of size instance.agent_number()
+    /**
+     * Value of the relaxation for the multipliers; lower_bound is this value
+     * rounded up.
+     */
+    double value = 0;
+    /**
+     * reduced_costs[j][i] is the increase of value when xij is fixed to 1,
+     * see reduced_cost_fixing().
+     */
+    std::vector<std::vector<double>> reduced_costs;
 };
 
 LagRelaxKnapsackLbfgsOutput lagrelax_knapsack_lbfgs(const Instance& instance, Info info = Info());
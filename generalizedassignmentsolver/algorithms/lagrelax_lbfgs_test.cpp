@@ -2,5 +2,79 @@
 #include "generalizedassignmentsolver/generator.hpp"
 #include "generalizedassignmentsolver/algorithms/lagrelax_lbfgs.hpp"
 
+#include <functional>
+
 using namespace generalizedassignmentsolver;
 
+
+/** Small random instance whose feasible solutions can be enumerated. */
+Instance lagrelax_lbfgs_instance_test(ItemIdx n, AgentIdx m, Seed seed)
+{
+    std::mt19937_64 generator(seed);
+    std::uniform_int_distribution<Weight> d_weight(1, 20);
+    std::uniform_int_distribution<Weight> d_capacity(15, 35);
+    std::uniform_int_distribution<Cost> d_cost(1, 50);
+    InstanceBuilder builder(n, m);
+    for (AgentIdx i = 0; i < m; ++i)
+        builder.set_capacity(i, d_capacity(generator));
+    for (ItemIdx j = 0; j < n; ++j)
+        for (AgentIdx i = 0; i < m; ++i)
+            builder.set_alternative(j, i, d_weight(generator), d_cost(generator));
+    return builder.build();
+}
+
+/**
+ * Check that every feasible solution of 'instance' costs at least value plus
+ * the reduced costs of each of its alternatives.
+ */
+void lagrelax_lbfgs_check_reduced_costs(
+        const Instance& instance,
+        double value,
+        const std::vector<std::vector<double>>& reduced_costs,
+        double tolerance)
+{
+    ItemIdx n = instance.item_number();
+    Solution solution(instance);
+    std::function<void(ItemIdx)> enumerate = [&](ItemIdx j)
+    {
+        if (j == n) {
+            if (!solution.feasible())
+                return;
+            for (ItemIdx j = 0; j < n; ++j) {
+                EXPECT_GE(solution.cost() + tolerance,
+                        value + reduced_costs[j][solution.agent(j)]);
+            }
+            return;
+        }
+        for (AgentIdx i: instance.eligible_agents(j)) {
+            solution.set(j, i);
+            if (solution.remaining_capacity(i) >= 0)
+                enumerate(j + 1);
+        }
+        solution.set(j, -1);
+    };
+    enumerate(0);
+}
+
+TEST(LagRelaxLbfgs, KnapsackReducedCosts)
+{
+    for (Seed seed = 0; seed < 10; ++seed) {
+        Instance instance = lagrelax_lbfgs_instance_test(7, 3, seed);
+        auto output = lagrelax_knapsack_lbfgs(instance, Info().set_verbose(false));
+        EXPECT_GE(output.lower_bound, (Cost)std::ceil(output.value - TOL));
+        lagrelax_lbfgs_check_reduced_costs(instance, output.value, output.reduced_costs, 1e-6);
+    }
+}
+
+TEST(LagRelaxLbfgs, AssignmentReducedCosts)
+{
+    for (Seed seed = 0; seed < 10; ++seed) {
+        Instance instance = lagrelax_lbfgs_instance_test(7, 3, seed);
+        LagRelaxAssignmentLbfgsOptionalParameters parameters;
+        parameters.info.set_verbose(false);
+        auto output = lagrelax_assignment_lbfgs(instance, parameters);
+        EXPECT_GE(output.lower_bound, (Cost)std::ceil(output.value - TOL));
+        // The knapsack subproblems are solved with profits rounded to 1e-4.
+        lagrelax_lbfgs_check_reduced_costs(instance, output.value, output.reduced_costs, 1e-2);
+    }
+}
@@ -112,7 +112,7 @@ int LagRelaxAssignmentHook::compute_rc(const VOL_dvector& u, VOL_dvector& rc)
     ItemIdx n = instance_.item_number();
     AgentIdx m = instance_.agent_number();
     for (ItemIdx j = 0; j < n; ++j)
-        for (AgentIdx i = 0; i < m; ++i)
+        for (AgentIdx i: ins.eligible_agents(j))
             rc[m * j + i] = ins.cost(j, i) - u[j];
     return 0;
 }
@@ -135,11 +135,12 @@ int LagRelaxAssignmentHook::solve_subproblem(const VOL_dvector& dual, const VOL_
     //Weight mult = 10000;
     Weight mult = 1000000;
     std::vector<ItemIdx> indices(n);
+    for (int k = 0; k < x.size(); ++k)
+        x[k] = 0;
     for (AgentIdx i = 0; i < m; ++i) {
         knapsacksolver::Instance instance_kp;
         instance_kp.set_capacity(ins.capacity(i));
-        for (ItemIdx j = 0; j < n; ++j) {
-            x[m * j + i] = 0;
+        for (ItemIdx j: ins.eligible_items(i)) {
             knapsacksolver::Profit p = std::ceil(mult * dual[j] - mult * ins.cost(j, i));
             if (p > 0) {
                 instance_kp.add_item(ins.weight(j, i), p);
@@ -296,7 +297,7 @@ int LagRelaxKnapsackHook::compute_rc(const VOL_dvector& u, VOL_dvector& rc)
     ItemIdx n = instance_.item_number();
     AgentIdx m = instance_.agent_number();
     for (ItemIdx j = 0; j < n; ++j)
-        for (AgentIdx i = 0; i < m; ++i)
+        for (AgentIdx i: ins.eligible_agents(j))
             rc[m * j + i] = ins.cost(j, i) - u[i] * ins.weight(j, i);
     return 0;
 }
@@ -316,17 +317,21 @@ int LagRelaxKnapsackHook::solve_subproblem(const VOL_dvector& dual, const VOL_dv
         v[i] = ins.capacity(i);
     }
 
+    for (int k = 0; k < x.size(); ++k)
+        x[k] = 0;
     for (ItemIdx j = 0; j < n; ++j) {
         AgentIdx i_best = -1;
         double rc_best = -1;
-        for (AgentIdx i = 0; i < m; ++i) {
-            x[m * j + i] = 0;
+        for (AgentIdx i: ins.eligible_agents(j)) {
             if (i_best == -1
                     || rc_best > rc[m * j + i]) {
                 i_best = i;
                 rc_best = rc[m * j + i];
             }
         }
+        // Item j does not fit in any agent, the instance is infeasible.
+        if (i_best == -1)
+            continue;
         x[m * j + i_best] = 1;
         v[i_best] -= ins.weight(j, i_best);
         pcost += ins.cost(j, i_best);
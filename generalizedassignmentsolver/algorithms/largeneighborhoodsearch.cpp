@@ -0,0 +1,425 @@
+#include "generalizedassignmentsolver/algorithms/largeneighborhoodsearch.hpp"
+
+#include "generalizedassignmentsolver/algorithms/penaltylocalsearch.hpp"
+#include "generalizedassignmentsolver/algorithms/branchandcut_cbc.hpp"
+
+#include "knapsacksolver/algorithms/minknap.hpp"
+
+#include <random>
+#include <algorithm>
+#include <numeric>
+#include <cstdlib>
+#include <vector>
+#include <thread>
+#include <atomic>
+
+using namespace generalizedassignmentsolver;
+
+LargeNeighborhoodSearchOutput& LargeNeighborhoodSearchOutput::algorithm_end(Info& info)
+{
+    PUT(info, "Algorithm", "Iterations", iterations);
+    PUT(info, "Algorithm", "Subproblems", subproblems);
+    PUT(info, "Algorithm", "Improvements", improvements);
+    Output::algorithm_end(info);
+    VER(info, "Iterations: " << iterations << std::endl);
+    VER(info, "Subproblems: " << subproblems << std::endl);
+    VER(info, "Improvements: " << improvements << std::endl);
+    return *this;
+}
+
+struct LargeNeighborhoodSearchSubproblem
+{
+    std::vector<AgentIdx> agents;
+    /** Items assigned to the agents of the subproblem. */
+    std::vector<ItemIdx> items;
+    /** New agents of the items; empty if the subproblem has not been improved. */
+    std::vector<AgentIdx> solution;
+};
+
+/**
+ * Assign the items of a subproblem with 2 agents a and b.
+ *
+ * Let A be the set of items assigned to agent a. The capacity constraint of
+ * agent b is sum_{j in A} wjb >= L. It is relaxed in a Lagrangian way: the
+ * profit of item j in the knapsack problem of agent a is
+ * cjb - cja + lambda * wjb, and the smallest multiplier lambda leading to a
+ * feasible assignment is found by binary search. If lambda = 0 is feasible,
+ * the assignment is optimal.
+ *
+ * Return false if no feasible assignment has been found; otherwise, agents
+ * contains the best one.
+ */
+bool largeneighborhoodsearch_knapsack(
+        const Instance& instance,
+        const std::vector<ItemIdx>& items,
+        AgentIdx a,
+        AgentIdx b,
+        std::vector<AgentIdx>& agents)
+{
+    // Items which don't fit in agent b are assigned to agent a, the other
+    // ones are initially assigned to agent b.
+    Weight capacity_a = instance.capacity(a);
+    Weight weight_b_min = -instance.capacity(b);
+    std::vector<ItemPos> free_items;
+    knapsacksolver::Profit lambda_max = 1;
+    agents.resize(items.size());
+    for (ItemPos pos = 0; pos < (ItemPos)items.size(); ++pos) {
+        ItemIdx j = items[pos];
+        if (!instance.eligible(j, b)) {
+            agents[pos] = a;
+            capacity_a -= instance.weight(j, a);
+            continue;
+        }
+        agents[pos] = b;
+        weight_b_min += instance.weight(j, b);
+        if (instance.eligible(j, a)) {
+            free_items.push_back(pos);
+            lambda_max += std::abs(instance.cost(j, b) - instance.cost(j, a));
+        }
+    }
+    if (capacity_a < 0)
+        return false;
+
+    // Solve the knapsack problem for multiplier lambda; return the weight in
+    // agent b and the cost saved by the items assigned to agent a.
+    std::vector<int8_t> in_a(free_items.size(), 0);
+    std::vector<ItemPos> kp2pos;
+    auto solve = [&](knapsacksolver::Profit lambda)
+    {
+        knapsacksolver::Instance instance_kp;
+        instance_kp.set_capacity(capacity_a);
+        kp2pos.clear();
+        for (ItemPos pos = 0; pos < (ItemPos)free_items.size(); ++pos) {
+            ItemIdx j = items[free_items[pos]];
+            knapsacksolver::Profit profit = instance.cost(j, b) - instance.cost(j, a)
+                + lambda * instance.weight(j, b);
+            if (profit <= 0)
+                continue;
+            instance_kp.add_item(instance.weight(j, a), profit);
+            kp2pos.push_back(pos);
+        }
+        std::fill(in_a.begin(), in_a.end(), 0);
+        if (instance_kp.item_number() > 0) {
+            auto output_kp = knapsacksolver::minknap(instance_kp);
+            for (knapsacksolver::ItemIdx j_kp = 0; j_kp < instance_kp.item_number(); ++j_kp)
+                if (output_kp.solution.contains_idx(j_kp))
+                    in_a[kp2pos[j_kp]] = 1;
+        }
+        Weight weight_a_b = 0;
+        Cost saving = 0;
+        for (ItemPos pos = 0; pos < (ItemPos)free_items.size(); ++pos) {
+            if (!in_a[pos])
+                continue;
+            ItemIdx j = items[free_items[pos]];
+            weight_a_b += instance.weight(j, b);
+            saving += instance.cost(j, b) - instance.cost(j, a);
+        }
+        return std::pair<Weight, Cost>(weight_a_b, saving);
+    };
+
+    bool found = false;
+    Cost saving_best = 0;
+    std::vector<int8_t> in_a_best;
+    auto evaluate = [&](knapsacksolver::Profit lambda)
+    {
+        auto p = solve(lambda);
+        if (p.first < weight_b_min)
+            return false;
+        if (!found || saving_best < p.second) {
+            found = true;
+            saving_best = p.second;
+            in_a_best = in_a;
+        }
+        return true;
+    };
+
+    // With lambda_max, the weight in agent b of the items assigned to agent
+    // a is maximized first; if it is not feasible, no assignment is.
+    if (!evaluate(0)) {
+        if (!evaluate(lambda_max))
+            return false;
+        knapsacksolver::Profit lambda_lo = 0;
+        knapsacksolver::Profit lambda_hi = lambda_max;
+        while (lambda_hi - lambda_lo > 1) {
+            knapsacksolver::Profit lambda = (lambda_lo + lambda_hi) / 2;
+            if (evaluate(lambda)) {
+                lambda_hi = lambda;
+            } else {
+                lambda_lo = lambda;
+            }
+        }
+    }
+
+    for (ItemPos pos = 0; pos < (ItemPos)free_items.size(); ++pos)
+        if (in_a_best[pos])
+            agents[free_items[pos]] = a;
+    return true;
+}
+
+#if COINOR_FOUND
+
+/** Solve the subproblem with branchandcut_cbc. */
+void largeneighborhoodsearch_cbc(
+        const Solution& solution,
+        LargeNeighborhoodSearchSubproblem& subproblem,
+        const LargeNeighborhoodSearchOptionalParameters& parameters)
+{
+    const Instance& instance = solution.instance();
+    ItemIdx n = subproblem.items.size();
+    AgentIdx m = subproblem.agents.size();
+    InstanceBuilder builder(n, m);
+    for (AgentPos i_pos = 0; i_pos < m; ++i_pos)
+        builder.set_capacity(i_pos, instance.capacity(subproblem.agents[i_pos]));
+    for (ItemPos j_pos = 0; j_pos < n; ++j_pos) {
+        ItemIdx j = subproblem.items[j_pos];
+        for (AgentPos i_pos = 0; i_pos < m; ++i_pos) {
+            AgentIdx i = subproblem.agents[i_pos];
+            builder.set_alternative(j_pos, i_pos, instance.weight(j, i), instance.cost(j, i));
+        }
+    }
+    Instance instance_sub = builder.build();
+
+    Solution solution_sub(instance_sub);
+    for (ItemPos j_pos = 0; j_pos < n; ++j_pos) {
+        AgentIdx i = solution.agent(subproblem.items[j_pos]);
+        AgentPos i_pos = std::find(subproblem.agents.begin(), subproblem.agents.end(), i)
+            - subproblem.agents.begin();
+        solution_sub.set(j_pos, i_pos);
+    }
+
+    BranchAndCutCbcOptionalParameters parameters_cbc;
+    parameters_cbc.info.set_verbose(false);
+    parameters_cbc.info.set_timelimit(std::min(
+                parameters.info.remaining_time(),
+                parameters.subproblem_time_limit));
+    parameters_cbc.initial_solution = &solution_sub;
+    auto output_cbc = branchandcut_cbc(instance_sub, parameters_cbc);
+    if (!output_cbc.solution.feasible()
+            || output_cbc.solution.cost() >= solution_sub.cost())
+        return;
+    subproblem.solution.resize(n);
+    for (ItemPos j_pos = 0; j_pos < n; ++j_pos)
+        subproblem.solution[j_pos] = subproblem.agents[output_cbc.solution.agent(j_pos)];
+}
+
+#endif
+
+void largeneighborhoodsearch_solve(
+        const Solution& solution,
+        LargeNeighborhoodSearchSubproblem& subproblem,
+        const LargeNeighborhoodSearchOptionalParameters& parameters)
+{
+    const Instance& instance = solution.instance();
+    subproblem.solution.clear();
+    Cost cost = 0;
+    for (AgentIdx i: subproblem.agents)
+        cost += solution.cost(i);
+
+    if (subproblem.agents.size() == 2) {
+        std::vector<AgentIdx> agents;
+        if (largeneighborhoodsearch_knapsack(
+                    instance,
+                    subproblem.items,
+                    subproblem.agents[0],
+                    subproblem.agents[1],
+                    agents)) {
+            Cost cost_new = 0;
+            for (ItemPos pos = 0; pos < (ItemPos)subproblem.items.size(); ++pos)
+                cost_new += instance.cost(subproblem.items[pos], agents[pos]);
+            if (cost > cost_new)
+                subproblem.solution = agents;
+        }
+        return;
+    }
+
+#if COINOR_FOUND
+    largeneighborhoodsearch_cbc(solution, subproblem, parameters);
+#else
+    (void)parameters;
+#endif
+}
+
+/**
+ * Partition the agents into groups of agent_number agents according to
+ * 'strategy':
+ * - 0: randomly
+ * - 1: by load; the most loaded agents are grouped with the least loaded ones
+ * - 2: by correlation; an agent is added to a group if it is a candidate agent
+ *   of many items of the group, and if the agents of the group are candidate
+ *   agents of many of its items
+ */
+std::vector<std::vector<AgentIdx>> largeneighborhoodsearch_groups(
+        const Solution& solution,
+        const std::vector<std::vector<ItemIdx>>& agent_items,
+        AgentIdx agent_number,
+        int strategy,
+        std::mt19937_64& generator)
+{
+    const Instance& instance = solution.instance();
+    AgentIdx m = instance.agent_number();
+    std::vector<AgentIdx> agents(m);
+    std::iota(agents.begin(), agents.end(), 0);
+    std::shuffle(agents.begin(), agents.end(), generator);
+    std::vector<std::vector<AgentIdx>> groups;
+
+    if (strategy == 0) {
+        for (AgentPos pos = 0; pos + agent_number <= m; pos += agent_number)
+            groups.push_back(std::vector<AgentIdx>(
+                        agents.begin() + pos, agents.begin() + pos + agent_number));
+    } else if (strategy == 1) {
+        std::stable_sort(agents.begin(), agents.end(),
+                [&solution, &instance](AgentIdx i1, AgentIdx i2)
+                {
+                    return (double)solution.weight(i1) / instance.capacity(i1)
+                        > (double)solution.weight(i2) / instance.capacity(i2);
+                });
+        AgentPos first = 0;
+        AgentPos last = m - 1;
+        while (last - first + 1 >= agent_number) {
+            std::vector<AgentIdx> group;
+            for (AgentPos k = 0; k < agent_number; ++k)
+                group.push_back((k % 2 == 0)? agents[first++]: agents[last--]);
+            groups.push_back(group);
+        }
+    } else {
+        std::vector<int8_t> grouped(m, 0);
+        for (AgentIdx i_seed: agents) {
+            if (grouped[i_seed])
+                continue;
+            std::vector<AgentIdx> group = {i_seed};
+            grouped[i_seed] = 1;
+            while ((AgentIdx)group.size() < agent_number) {
+                AgentIdx i_best = -1;
+                ItemIdx score_best = -1;
+                for (AgentIdx i: agents) {
+                    if (grouped[i])
+                        continue;
+                    ItemIdx score = 0;
+                    for (AgentIdx i_group: group) {
+                        for (ItemIdx j: agent_items[i_group])
+                            if (instance.candidate(j, i))
+                                score++;
+                        for (ItemIdx j: agent_items[i])
+                            if (instance.candidate(j, i_group))
+                                score++;
+                    }
+                    if (score_best < score) {
+                        score_best = score;
+                        i_best = i;
+                    }
+                }
+                if (i_best == -1)
+                    break;
+                group.push_back(i_best);
+                grouped[i_best] = 1;
+            }
+            if ((AgentIdx)group.size() == agent_number)
+                groups.push_back(group);
+        }
+    }
+    return groups;
+}
+
+LargeNeighborhoodSearchOutput generalizedassignmentsolver::largeneighborhoodsearch(
+        const Instance& instance,
+        std::mt19937_64& generator,
+        LargeNeighborhoodSearchOptionalParameters parameters)
+{
+    VER(parameters.info, "*** largeneighborhoodsearch ***" << std::endl);
+    LargeNeighborhoodSearchOutput output(instance, parameters.info);
+    AgentIdx m = instance.agent_number();
+    Counter thread_number = std::max((Counter)1, parameters.thread_number);
+
+    // Initial solution.
+    Solution solution(instance);
+    if (parameters.initial_solution != nullptr
+            && parameters.initial_solution->feasible()) {
+        solution = *parameters.initial_solution;
+    } else {
+        PenaltyLocalSearchOptionalParameters parameters_local_search;
+        parameters_local_search.info.set_verbose(false);
+        parameters_local_search.info.set_timelimit(parameters.info.remaining_time());
+        parameters_local_search.thread_number = thread_number;
+        solution = penaltylocalsearch(instance, generator, parameters_local_search).solution;
+    }
+    if (!solution.feasible())
+        return output.algorithm_end(parameters.info);
+    output.update_solution(solution, std::stringstream("initial solution"), parameters.info);
+
+    AgentIdx agent_number_min = std::max((AgentIdx)2, parameters.minimum_agent_number);
+    AgentIdx agent_number_max = std::max(agent_number_min, parameters.maximum_agent_number);
+#if !COINOR_FOUND
+    agent_number_min = 2;
+    agent_number_max = 2;
+#endif
+    agent_number_max = std::min(agent_number_max, m);
+    if (agent_number_min > agent_number_max)
+        return output.algorithm_end(parameters.info);
+    std::uniform_int_distribution<AgentIdx> d_agent_number(agent_number_min, agent_number_max);
+
+    std::vector<std::vector<ItemIdx>> agent_items(m);
+    Counter iterations_without_improvement = 0;
+    for (output.iterations = 0; parameters.info.check_time(); ++output.iterations) {
+        if (parameters.iteration_limit != -1
+                && iterations_without_improvement >= parameters.iteration_limit)
+            break;
+
+        // Build the subproblems.
+        for (AgentIdx i = 0; i < m; ++i)
+            agent_items[i].clear();
+        for (ItemIdx j = 0; j < instance.item_number(); ++j)
+            agent_items[solution.agent(j)].push_back(j);
+        AgentIdx agent_number = d_agent_number(generator);
+        auto groups = largeneighborhoodsearch_groups(
+                solution, agent_items, agent_number, output.iterations % 3, generator);
+        std::vector<LargeNeighborhoodSearchSubproblem> subproblems(groups.size());
+        for (Counter pos = 0; pos < (Counter)groups.size(); ++pos) {
+            subproblems[pos].agents = groups[pos];
+            for (AgentIdx i: groups[pos])
+                for (ItemIdx j: agent_items[i])
+                    subproblems[pos].items.push_back(j);
+        }
+
+        // Solve the subproblems.
+        std::atomic<Counter> pos_next(0);
+        auto worker = [&solution, &subproblems, &parameters, &pos_next]()
+        {
+            for (;;) {
+                Counter pos = pos_next++;
+                if (pos >= (Counter)subproblems.size())
+                    break;
+                if (!parameters.info.check_time())
+                    break;
+                largeneighborhoodsearch_solve(solution, subproblems[pos], parameters);
+            }
+        };
+        std::vector<std::thread> threads;
+        for (Counter t = 1; t < thread_number; ++t)
+            threads.push_back(std::thread(worker));
+        worker();
+        for (std::thread& thread: threads)
+            thread.join();
+        output.subproblems += std::min((Counter)subproblems.size(), (Counter)pos_next);
+
+        // Apply the improvements.
+        bool improved = false;
+        for (const LargeNeighborhoodSearchSubproblem& subproblem: subproblems) {
+            if (subproblem.solution.empty())
+                continue;
+            for (ItemPos pos = 0; pos < (ItemPos)subproblem.items.size(); ++pos)
+                solution.set(subproblem.items[pos], subproblem.solution[pos]);
+            output.improvements++;
+            improved = true;
+        }
+        if (improved) {
+            iterations_without_improvement = 0;
+            std::stringstream ss;
+            ss << "it " << output.iterations << " k " << agent_number;
+            output.update_solution(solution, ss, parameters.info);
+        } else {
+            iterations_without_improvement++;
+        }
+    }
+
+    return output.algorithm_end(parameters.info);
+}
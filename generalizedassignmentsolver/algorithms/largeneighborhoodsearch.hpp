@@ -0,0 +1,61 @@
+#pragma once
+
+#include "generalizedassignmentsolver/solution.hpp"
+
+namespace generalizedassignmentsolver
+{
+
+struct LargeNeighborhoodSearchOptionalParameters
+{
+    Info info = Info();
+
+    Counter thread_number = 1;
+    /** Maximum number of rounds without improvement; -1 for no limit. */
+    Counter iteration_limit = 50;
+    /**
+     * Bounds of the number of agents of a subproblem. Subproblems with more
+     * than 2 agents are solved with branchandcut_cbc; without CBC, all
+     * subproblems have 2 agents.
+     */
+    AgentIdx minimum_agent_number = 2;
+    AgentIdx maximum_agent_number = 4;
+    /** Time limit of each branchandcut_cbc subproblem. */
+    double subproblem_time_limit = 1;
+    const Solution* initial_solution = nullptr;
+};
+
+struct LargeNeighborhoodSearchOutput: Output
+{
+    LargeNeighborhoodSearchOutput(const Instance& instance, Info& info): Output(instance, info) { }
+    LargeNeighborhoodSearchOutput& algorithm_end(Info& info);
+
+    Counter iterations = 0;
+    Counter subproblems = 0;
+    Counter improvements = 0;
+};
+
+/**
+ * Large neighborhood search reoptimizing the items of a few agents.
+ *
+ * At each round, the agents are partitioned into groups of a few agents,
+ * either randomly, by pairing loaded agents with free ones, or by grouping
+ * agents sharing many candidate items. For each group, the assignment of the
+ * items of its agents is reoptimized:
+ * - For 2 agents a and b, knapsack problems of agent a are solved with
+ *   minknap: the profit of an item is the cost saved by assigning it to a
+ *   instead of b, plus a Lagrangian term for the capacity of agent b whose
+ *   multiplier is adjusted by binary search. The assignment is optimal if
+ *   the capacity of agent b is not binding.
+ * - Otherwise, the subproblem is solved with branchandcut_cbc.
+ * The groups are disjoint: their subproblems are solved in parallel and all
+ * their improvements are applied.
+ *
+ * If the initial solution is not feasible, a feasible solution is first
+ * computed with penaltylocalsearch.
+ */
+LargeNeighborhoodSearchOutput largeneighborhoodsearch(
+        const Instance& instance,
+        std::mt19937_64& generator,
+        LargeNeighborhoodSearchOptionalParameters parameters = {});
+
+}
@@ -2,6 +2,17 @@
 
 #include "generalizedassignmentsolver/solution.hpp"
 
+#include "localsearchsolver/a_star.hpp"
+
+#include <random>
+#include <algorithm>
+#include <numeric>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
 namespace generalizedassignmentsolver
 {
 
@@ -11,6 +22,22 @@ struct LocalSearchOptionalParameters
 
     Counter thread_number = 1;
     const Solution* initial_solution = nullptr;
+
+    /** Maximum length of the ejection chains, 2 for swaps only. */
+    Counter ejection_chain_maximum_length = 2;
+    /**
+     * Number of cheapest agents of each item to which the neighborhoods move
+     * it if the instance has no candidate lists; 0 for all.
+     */
+    AgentPos candidate_agent_number = 0;
+    /** Number of agents explored at each step of an ejection chain; 0 for all. */
+    AgentPos ejection_chain_agent_number = 4;
+    /** Number of items ejected at each step of an ejection chain; 0 for all. */
+    ItemPos ejection_chain_item_number = 8;
+    /** Number of threads evaluating the neighborhood of each descent. */
+    Counter neighborhood_thread_number = 1;
+    /** Number of best perturbations explored from each solution; 0 for all. */
+    Counter perturbation_number = 0;
 };
 
 struct LocalSearchOutput: Output
@@ -19,6 +46,863 @@ struct LocalSearchOutput: Output
     LocalSearchOutput& algorithm_end(Info& info);
 };
 
+/**
+ * Threads sharing the neighborhood evaluation of a single descent.
+ *
+ * run(f) calls f(t) for t in [0, thread_number()), f(0) on the calling
+ * thread and the others on the worker threads, and returns once all the
+ * calls have returned. The worker threads wait between two calls.
+ */
+class NeighborhoodThreads
+{
+
+public:
+
+    NeighborhoodThreads(Counter thread_number)
+    {
+        for (Counter t = 1; t < thread_number; ++t)
+            threads_.emplace_back(&NeighborhoodThreads::work, this, t);
+    }
+
+    ~NeighborhoodThreads()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        task_cv_.notify_all();
+        for (std::thread& thread: threads_)
+            thread.join();
+    }
+
+    Counter thread_number() const { return threads_.size() + 1; }
+
+    void run(const std::function<void (Counter)>& task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            task_ = &task;
+            running_thread_number_ = threads_.size();
+            generation_++;
+        }
+        task_cv_.notify_all();
+        task(0);
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_cv_.wait(lock, [this]() { return running_thread_number_ == 0; });
+        task_ = nullptr;
+    }
+
+private:
+
+    void work(Counter t)
+    {
+        Counter generation = 0;
+        for (;;) {
+            const std::function<void (Counter)>* task = nullptr;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                task_cv_.wait(lock, [this, generation]() { return stop_ || generation_ != generation; });
+                if (stop_)
+                    return;
+                generation = generation_;
+                task = task_;
+            }
+            (*task)(t);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                running_thread_number_--;
+            }
+            done_cv_.notify_one();
+        }
+    }
+
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable task_cv_;
+    std::condition_variable done_cv_;
+    const std::function<void (Counter)>* task_ = nullptr;
+    Counter generation_ = 0;
+    Counter running_thread_number_ = 0;
+    bool stop_ = false;
+
+};
+
+/** Local scheme of localsearch, explored by localsearchsolver::a_star. */
+class LocalScheme
+{
+
+public:
+
+    /** Global cost: <Item number, Overweight, Cost>; */
+    using GlobalCost = std::tuple<ItemIdx, Weight, Cost>;
+
+    inline ItemIdx&       item_number(GlobalCost& global_cost) const { return std::get<0>(global_cost); }
+    inline Weight&         overweight(GlobalCost& global_cost) const { return std::get<1>(global_cost); }
+    inline Cost&                 cost(GlobalCost& global_cost) const { return std::get<2>(global_cost); }
+    inline ItemIdx  item_number(const GlobalCost& global_cost) const { return std::get<0>(global_cost); }
+    inline Weight    overweight(const GlobalCost& global_cost) const { return std::get<1>(global_cost); }
+    inline Cost            cost(const GlobalCost& global_cost) const { return std::get<2>(global_cost); }
+
+    static GlobalCost global_cost_worst()
+    {
+        return {
+            std::numeric_limits<ItemIdx>::max(),
+            std::numeric_limits<Weight>::max(),
+            std::numeric_limits<Cost>::max(),
+        };
+    }
+
+    /*
+     * Solutions.
+     */
+
+    /**
+     * Compact solution: the agent of each item (plus one, 0 meaning
+     * unassigned) stored on bit_number_ bits, and the hash of the solution.
+     */
+    struct CompactSolution
+    {
+        std::vector<uint64_t> words;
+        uint64_t hash = 0;
+
+        bool operator==(const CompactSolution& compact_solution) const
+        {
+            return hash == compact_solution.hash
+                && words == compact_solution.words;
+        }
+    };
+
+    struct CompactSolutionHasher
+    {
+        inline bool operator()(
+                const std::shared_ptr<CompactSolution>& compact_solution_1,
+                const std::shared_ptr<CompactSolution>& compact_solution_2) const
+        {
+            return *compact_solution_1 == *compact_solution_2;
+        }
+
+        inline std::size_t operator()(
+                const std::shared_ptr<CompactSolution>& compact_solution) const
+        {
+            return compact_solution->hash;
+        }
+    };
+
+    inline CompactSolutionHasher compact_solution_hasher() const { return CompactSolutionHasher(); }
+
+    struct Solution
+    {
+        std::vector<AgentIdx> agents;
+        std::vector<Weight> weights;
+        ItemIdx item_number = 0;
+        Weight overweight = 0;
+        Cost cost = 0;
+        /** Zobrist hash of the assignment, updated by add() and remove(). */
+        uint64_t hash = 0;
+    };
+
+    CompactSolution solution2compact(const Solution& solution)
+    {
+        CompactSolution compact_solution;
+        compact_solution.words.resize((instance_.item_number() * bit_number_ + 63) / 64, 0);
+        for (ItemIdx j = 0; j < instance_.item_number(); ++j) {
+            uint64_t value = solution.agents[j] + 1;
+            std::size_t bit = j * bit_number_;
+            compact_solution.words[bit / 64] |= value << (bit % 64);
+            if (bit % 64 + bit_number_ > 64)
+                compact_solution.words[bit / 64 + 1] |= value >> (64 - bit % 64);
+        }
+        compact_solution.hash = solution.hash;
+        return compact_solution;
+    }
+
+    Solution compact2solution(const CompactSolution& compact_solution)
+    {
+        Solution solution = empty_solution();
+        uint64_t mask = (bit_number_ == 64)? ~(uint64_t)0: ((uint64_t)1 << bit_number_) - 1;
+        for (ItemIdx j = 0; j < instance_.item_number(); ++j) {
+            std::size_t bit = j * bit_number_;
+            uint64_t value = compact_solution.words[bit / 64] >> (bit % 64);
+            if (bit % 64 + bit_number_ > 64)
+                value |= compact_solution.words[bit / 64 + 1] << (64 - bit % 64);
+            AgentIdx i = (AgentIdx)(value & mask) - 1;
+            if (i != -1)
+                add(solution, j, i);
+        }
+        return solution;
+    }
+
+    /*
+     * Constructors and destructor.
+     */
+
+    struct Parameters
+    {
+        const generalizedassignmentsolver::Solution* initial_solution = NULL;
+
+        /**
+         * Maximum length of the ejection chains explored when no shift move
+         * improves the solution; chains of length 2 which end on their
+         * starting agent are swaps. 0 or 1 disables ejection chains.
+         */
+        Counter ejection_chain_maximum_length = 2;
+
+        /**
+         * If the instance has no candidate lists (see
+         * Instance::set_candidate_agents), number of cheapest eligible agents
+         * of each item to which the neighborhoods move it; 0 for all of them.
+         */
+        AgentPos candidate_agent_number = 0;
+
+        /**
+         * Number of cheapest candidate agents to which an item may be moved
+         * at each step of an ejection chain; 0 for all of them.
+         */
+        AgentPos ejection_chain_agent_number = 4;
+
+        /**
+         * Number of items, sampled at random, which may be ejected from the
+         * destination agent at each step of an ejection chain; 0 for all of
+         * them.
+         */
+        ItemPos ejection_chain_item_number = 8;
+
+        /** Number of threads evaluating the shift moves of a descent. */
+        Counter neighborhood_thread_number = 1;
+
+        /** Number of best perturbations returned; 0 for all of them. */
+        Counter perturbation_number = 0;
+    };
+
+    LocalScheme(
+            const Instance& instance,
+            Parameters parameters):
+        instance_(instance),
+        parameters_(parameters),
+        items_(instance.item_number()),
+        move_agents_(instance.item_number()),
+        move_deltas_(instance.item_number()),
+        agent_items_(instance.agent_number()),
+        candidate_agents_(instance.item_number()),
+        ejection_chain_agents_(instance.item_number())
+    {
+        std::iota(items_.begin(), items_.end(), 0);
+
+        // Compute the candidate agents of each item, sorted by index.
+        restricted_candidate_agents_ = (instance.candidate_agent_number() == 0
+                && parameters.candidate_agent_number > 0);
+        for (ItemIdx j = 0; j < instance.item_number(); ++j) {
+            auto agents = instance.candidate_agents(j);
+            std::vector<AgentIdx>& candidate_agents = candidate_agents_[j];
+            candidate_agents.assign(agents.begin(), agents.end());
+            AgentPos k = parameters.candidate_agent_number;
+            if (restricted_candidate_agents_ && (AgentPos)candidate_agents.size() > k) {
+                std::nth_element(
+                        candidate_agents.begin(),
+                        candidate_agents.begin() + k - 1,
+                        candidate_agents.end(),
+                        [&instance, j](AgentIdx i1, AgentIdx i2) -> bool
+                        {
+                            return instance.cost(j, i1) < instance.cost(j, i2);
+                        });
+                candidate_agents.resize(k);
+                std::sort(candidate_agents.begin(), candidate_agents.end());
+            }
+        }
+
+        // Compute the agents of each item explored in ejection chains.
+        for (ItemIdx j = 0; j < instance.item_number(); ++j) {
+            std::vector<AgentIdx>& ejection_chain_agents = ejection_chain_agents_[j];
+            ejection_chain_agents = candidate_agents_[j];
+            AgentPos k = parameters.ejection_chain_agent_number;
+            if (k > 0 && (AgentPos)ejection_chain_agents.size() > k) {
+                std::partial_sort(
+                        ejection_chain_agents.begin(),
+                        ejection_chain_agents.begin() + k,
+                        ejection_chain_agents.end(),
+                        [&instance, j](AgentIdx i1, AgentIdx i2) -> bool
+                        {
+                            return instance.cost(j, i1) < instance.cost(j, i2);
+                        });
+                ejection_chain_agents.resize(k);
+            }
+        }
+        while (((AgentIdx)1 << bit_number_) < instance.agent_number() + 1)
+            bit_number_++;
+        if (parameters.neighborhood_thread_number > 1)
+            neighborhood_threads_.reset(new NeighborhoodThreads(parameters.neighborhood_thread_number));
+        best_positions_.resize(
+                (neighborhood_threads_ == nullptr)? 1: neighborhood_threads_->thread_number());
+    }
+
+    LocalScheme(const LocalScheme& local_scheme):
+        LocalScheme(local_scheme.instance_, local_scheme.parameters_) { }
+
+    virtual ~LocalScheme() { }
+
+    /*
+     * Initial solutions.
+     */
+
+    inline Solution empty_solution() const
+    {
+        Solution solution;
+        solution.agents.resize(instance_.item_number(), -1);
+        solution.weights.resize(instance_.agent_number(), 0);
+        return solution;
+    }
+
+    inline Solution initial_solution(
+            Counter,
+            std::mt19937_64& generator) const
+    {
+        Solution solution = empty_solution();
+        if (parameters_.initial_solution != nullptr) {
+            for (ItemIdx j = 0; j < instance_.item_number(); ++j) {
+                AgentIdx i = parameters_.initial_solution->agent(j);
+                if (i != -1)
+                    add(solution, j, i);
+            }
+        }
+
+        for (ItemIdx j = 0; j < instance_.item_number(); ++j) {
+            if (solution.agents[j] != -1)
+                continue;
+            auto agents = instance_.eligible_agents(j);
+            AgentIdx i = -1;
+            if (agents.empty()) {
+                std::uniform_int_distribution<AgentIdx> d(0, instance_.agent_number() - 1);
+                i = d(generator);
+            } else {
+                std::uniform_int_distribution<AgentPos> d(0, agents.size() - 1);
+                i = agents[d(generator)];
+            }
+            add(solution, j, i);
+        }
+        return solution;
+    }
+
+    /*
+     * Solution properties.
+     */
+
+    inline GlobalCost global_cost(const Solution& solution) const
+    {
+        return {
+            -solution.item_number,
+            solution.overweight,
+            solution.cost,
+        };
+    }
+
+    /*
+     * Local search.
+     */
+
+    struct Move
+    {
+        ItemIdx j;
+        AgentIdx i;
+        GlobalCost global_cost;
+    };
+
+    static Move move_null() { return {-1, -1, global_cost_worst()}; }
+
+    struct MoveHasher
+    {
+        std::hash<ItemIdx> hasher_1;
+        std::hash<AgentIdx> hasher_2;
+
+        inline bool operator()(
+                const Move& move_1,
+                const Move& move_2) const
+        {
+            return move_1.j == move_2.j
+                && move_1.i == move_2.i;
+        }
+
+        inline std::size_t operator()(
+                const Move& move) const
+        {
+            auto hash = hasher_1(move.j);
+            optimizationtools::hash_combine(hash, hasher_2(move.i));
+            return hash;
+        }
+    };
+
+    inline MoveHasher move_hasher() const { return MoveHasher(); }
+
+    /**
+     * Return the shift moves of the solution.
+     *
+     * The moves are written in a buffer reused from one call to the next.
+     * If parameters_.perturbation_number is positive, only this number of
+     * best moves are kept, in increasing order of global cost.
+     */
+    inline const std::vector<Move>& perturbations(const Solution& solution) const
+    {
+        perturbations_.clear();
+        Counter k = parameters_.perturbation_number;
+        auto compare = [](const Move& move_1, const Move& move_2) -> bool
+        {
+            return move_1.global_cost < move_2.global_cost;
+        };
+        GlobalCost gc = global_cost(solution);
+        for (ItemIdx j = 0; j < instance_.item_number(); ++j) {
+            AgentIdx i_old = solution.agents[j];
+            for (AgentIdx i: instance_.eligible_agents(j)) {
+                if (i == i_old)
+                    continue;
+                GlobalCost d = shift_delta(solution, j, i);
+                Move move;
+                move.j = j;
+                move.i = i;
+                move.global_cost = gc;
+                item_number(move.global_cost) += item_number(d);
+                overweight(move.global_cost) += overweight(d);
+                cost(move.global_cost) += cost(d);
+                if (k <= 0) {
+                    perturbations_.push_back(move);
+                } else if ((Counter)perturbations_.size() < k) {
+                    // The worst kept move is at the top of the heap.
+                    perturbations_.push_back(move);
+                    std::push_heap(perturbations_.begin(), perturbations_.end(), compare);
+                } else if (compare(move, perturbations_.front())) {
+                    std::pop_heap(perturbations_.begin(), perturbations_.end(), compare);
+                    perturbations_.back() = move;
+                    std::push_heap(perturbations_.begin(), perturbations_.end(), compare);
+                }
+            }
+        }
+        if (k > 0)
+            std::sort_heap(perturbations_.begin(), perturbations_.end(), compare);
+        return perturbations_;
+    }
+
+    inline void apply_move(Solution& solution, const Move& move) const
+    {
+        remove(solution, move.j);
+        add(solution, move.j, move.i);
+    }
+
+    /**
+     * Descent.
+     *
+     * The best shift move of each item is stored in a move table. After a
+     * move, only the moves which depend on the load of the modified agents
+     * are re-evaluated. The items are split between the neighborhood threads,
+     * which update the move table and look for the best move of their items
+     * while the solution is read-only.
+     *
+     * When no shift move improves the solution, ejection chains are
+     * explored: an item is moved to one of its cheapest candidate agents,
+     * then an item of this agent is moved to one of its cheapest candidate
+     * agents, and so on. The first chain which improves the solution is
+     * applied. Each step explores at most ejection_chain_agent_number agents
+     * and ejection_chain_item_number items, so that a search evaluates
+     * O(n) chains for bounded lengths.
+     */
+    inline void local_search(
+            Solution& solution,
+            std::mt19937_64& generator,
+            const Move& tabu = move_null())
+    {
+        std::shuffle(items_.begin(), items_.end(), generator);
+        modified_agents_.clear();
+
+        Counter it = 0;
+        for (;; ++it) {
+            //std::cout << "it " << it << " cost " << to_string(global_cost(solution)) << std::endl;
+            ItemIdx j_best = update_moves(solution, tabu);
+            if (j_best == -1) {
+                if (parameters_.ejection_chain_maximum_length < 2)
+                    break;
+                if (!ejection_chain(solution, generator, tabu))
+                    break;
+                continue;
+            }
+            GlobalCost d_best = move_deltas_[j_best];
+            GlobalCost c_best = global_cost(solution);
+            item_number(c_best) += item_number(d_best);
+            overweight(c_best) += overweight(d_best);
+            cost(c_best) += cost(d_best);
+            AgentIdx i_old = solution.agents[j_best];
+            AgentIdx i_best = move_agents_[j_best];
+            if (i_old != -1)
+                remove(solution, j_best);
+            add(solution, j_best, i_best);
+            if (solution.cost != cost(c_best)) {
+                std::cout << localsearchsolver::to_string(c_best) << std::endl;
+                std::cout << localsearchsolver::to_string(global_cost(solution)) << std::endl;
+            }
+            assert(solution.cost == cost(c_best));
+            modified_agents_ = {i_old, i_best};
+        }
+    }
+
+    /** Number of ejection chain searches since the creation of the scheme. */
+    Counter ejection_chain_search_number() const { return ejection_chain_search_number_; }
+
+    /** Number of moves evaluated by these searches. */
+    Counter ejection_chain_move_number() const { return ejection_chain_move_number_; }
+
+    /*
+     * Outputs.
+     */
+
+    std::ostream& print(
+            std::ostream &os,
+            const Solution& solution) const
+    {
+        os << "item number: " << solution.item_number << std::endl;
+        os << "agents:";
+        for (AgentIdx i: solution.agents)
+            os << " " << i;
+        os << std::endl;
+        os << "weights:";
+        for (Weight w: solution.weights)
+            os << " " << w;
+        os << std::endl;
+        os << "overweight: " << solution.overweight << std::endl;
+        os << "cost: " << solution.cost << std::endl;
+        return os;
+    }
+
+    inline void write(
+            const Solution& solution,
+            std::string filepath) const
+    {
+        if (filepath.empty())
+            return;
+        std::ofstream cert(filepath);
+        if (!cert.good()) {
+            std::cerr << "\033[31m" << "ERROR, unable to open file \"" << filepath << "\"" << "\033[0m" << std::endl;
+            return;
+        }
+
+        for (AgentIdx i: solution.agents)
+            cert << i << " ";
+    }
+
+private:
+
+    /** Checks of the incremental structures in localsearch_test.cpp. */
+    friend class LocalSchemeTest;
+
+    /*
+     * Manipulate solutions.
+     */
+
+    inline void add(Solution& solution, ItemIdx j, AgentIdx i) const
+    {
+        assert(j >= 0);
+        assert(j < instance_.item_number());
+        assert(i >= 0);
+        assert(i < instance_.agent_number());
+        assert(solution.agents[j] == -1);
+        // Update item_number.
+        solution.item_number++;
+        // Update weights.
+        Weight w_max = instance_.capacity(i);
+        Weight w = instance_.weight(j, i);
+        if (solution.weights[i] >= w_max) {
+            solution.overweight += w;
+        } else if (solution.weights[i] + w <= w_max) {
+        } else {
+            solution.overweight += (solution.weights[i] + w - w_max);
+        }
+        solution.weights[i] += w;
+        // Update cost.
+        solution.cost += instance_.cost(j, i);
+        // Update items.
+        solution.agents[j] = i;
+        // Update hash.
+        solution.hash ^= zobrist_key(j, i);
+    }
+
+    inline void remove(Solution& solution, ItemIdx j) const
+    {
+        AgentIdx i = solution.agents[j];
+        assert(i != -1);
+        // Update item_number.
+        solution.item_number--;
+        // Update weights.
+        Weight w_max = instance_.capacity(i);
+        Weight w = instance_.weight(j, i);
+        if (solution.weights[i] - w >= w_max) {
+            solution.overweight -= w;
+        } else if (solution.weights[i] <= w_max) {
+        } else {
+            solution.overweight -= (solution.weights[i] - w_max);
+        }
+        solution.weights[i] -= w;
+        // Update cost.
+        solution.cost -= instance_.cost(j, i);
+        // Update items.
+        solution.agents[j] = -1;
+        // Update hash.
+        solution.hash ^= zobrist_key(j, i);
+    }
+
+    /**
+     * Zobrist key of alternative (j, i). Keys are computed on the fly with
+     * the SplitMix64 finalizer instead of being stored in an n x m table.
+     */
+    inline uint64_t zobrist_key(ItemIdx j, AgentIdx i) const
+    {
+        uint64_t z = (uint64_t)(j * instance_.agent_number() + i) + 0x9e3779b97f4a7c15;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+        return z ^ (z >> 31);
+    }
+
+    /*
+     * Evaluate moves.
+     */
+
+    /**
+     * Return the variation of the global cost when item j is moved to
+     * agent i.
+     */
+    inline GlobalCost shift_delta(
+            const Solution& solution,
+            ItemIdx j,
+            AgentIdx i) const
+    {
+        GlobalCost gc = {0, 0, 0};
+        AgentIdx i_old = solution.agents[j];
+        if (i_old == -1) {
+            item_number(gc)--;
+        } else {
+            Weight w_max = instance_.capacity(i_old);
+            Weight w_agent = solution.weights[i_old];
+            Weight w = instance_.weight(j, i_old);
+            overweight(gc) += std::max((Weight)0, w_agent - w - w_max)
+                - std::max((Weight)0, w_agent - w_max);
+            cost(gc) -= instance_.cost(j, i_old);
+        }
+        Weight w_max = instance_.capacity(i);
+        Weight w_agent = solution.weights[i];
+        Weight w = instance_.weight(j, i);
+        overweight(gc) += std::max((Weight)0, w_agent + w - w_max)
+            - std::max((Weight)0, w_agent - w_max);
+        cost(gc) += instance_.cost(j, i);
+        return gc;
+    }
+
+    /** Return true iff agent i is a candidate agent of item j. */
+    inline bool candidate(ItemIdx j, AgentIdx i) const
+    {
+        if (!restricted_candidate_agents_)
+            return instance_.candidate(j, i);
+        return std::binary_search(candidate_agents_[j].begin(), candidate_agents_[j].end(), i);
+    }
+
+    /** Compute the best shift move of item j. */
+    inline void evaluate_moves(
+            const Solution& solution,
+            ItemIdx j,
+            const Move& tabu)
+    {
+        move_agents_[j] = -1;
+        move_deltas_[j] = global_cost_worst();
+        for (AgentIdx i: candidate_agents_[j]) {
+            if (i == solution.agents[j])
+                continue;
+            if (j == tabu.j && i == tabu.i)
+                continue;
+            GlobalCost d = shift_delta(solution, j, i);
+            if (d < move_deltas_[j]) {
+                move_agents_[j] = i;
+                move_deltas_[j] = d;
+            }
+        }
+    }
+
+    /** Update the best shift move of item j after a modification of the load of 'agents'. */
+    inline void update_moves(
+            const Solution& solution,
+            ItemIdx j,
+            const std::vector<AgentIdx>& agents,
+            const Move& tabu)
+    {
+        if (std::find(agents.begin(), agents.end(), solution.agents[j]) != agents.end()
+                || std::find(agents.begin(), agents.end(), move_agents_[j]) != agents.end()) {
+            evaluate_moves(solution, j, tabu);
+            return;
+        }
+        // Only the moves to the modified agents changed.
+        for (AgentIdx i: agents) {
+            if (i == -1 || !candidate(j, i))
+                continue;
+            if (j == tabu.j && i == tabu.i)
+                continue;
+            GlobalCost d = shift_delta(solution, j, i);
+            if (d < move_deltas_[j]) {
+                move_agents_[j] = i;
+                move_deltas_[j] = d;
+            }
+        }
+    }
+
+    /**
+     * Update the move table after a modification of the load of the agents
+     * of modified_agents_ (all the moves if it is empty) and return the item
+     * of the best improving move, or -1.
+     *
+     * Ties are broken by position in items_, so that the result does not
+     * depend on the number of threads.
+     */
+    inline ItemIdx update_moves(
+            const Solution& solution,
+            const Move& tabu)
+    {
+        Counter thread_number = best_positions_.size();
+        ItemPos n = instance_.item_number();
+        auto task = [this, &solution, &tabu, thread_number, n](Counter t)
+        {
+            ItemPos p_best = -1;
+            GlobalCost d_best = {0, 0, 0};
+            for (ItemPos p = n * t / thread_number; p < n * (t + 1) / thread_number; ++p) {
+                ItemIdx j = items_[p];
+                if (modified_agents_.empty()) {
+                    evaluate_moves(solution, j, tabu);
+                } else {
+                    update_moves(solution, j, modified_agents_, tabu);
+                }
+                if (move_deltas_[j] < d_best) {
+                    p_best = p;
+                    d_best = move_deltas_[j];
+                }
+            }
+            best_positions_[t] = p_best;
+        };
+        if (neighborhood_threads_ == nullptr) {
+            task(0);
+        } else {
+            neighborhood_threads_->run(task);
+        }
+
+        // The threads handle increasing positions.
+        ItemIdx j_best = -1;
+        for (ItemPos p: best_positions_)
+            if (p != -1 && (j_best == -1 || move_deltas_[items_[p]] < move_deltas_[j_best]))
+                j_best = items_[p];
+        return j_best;
+    }
+
+    /**
+     * Look for an improving ejection chain; if one is found, apply it, store
+     * the agents it modifies in modified_agents_ and return true.
+     */
+    inline bool ejection_chain(
+            Solution& solution,
+            std::mt19937_64& generator,
+            const Move& tabu)
+    {
+        for (auto& items: agent_items_)
+            items.clear();
+        for (ItemIdx j = 0; j < instance_.item_number(); ++j)
+            if (solution.agents[j] != -1)
+                agent_items_[solution.agents[j]].push_back(j);
+        // The items ejected from an agent are the first ones of agent_items_.
+        for (auto& items: agent_items_)
+            std::shuffle(items.begin(), items.end(), generator);
+        std::shuffle(items_.begin(), items_.end(), generator);
+        ejection_chain_search_number_++;
+        GlobalCost c = global_cost(solution);
+        for (ItemIdx j: items_) {
+            if (solution.agents[j] == -1)
+                continue;
+            modified_agents_ = {solution.agents[j]};
+            if (ejection_chain(solution, j, 1, c, tabu))
+                return true;
+        }
+        return false;
+    }
+
+    /**
+     * Extend the current ejection chain by moving item j. The solution is
+     * restored if no improving chain is found.
+     */
+    inline bool ejection_chain(
+            Solution& solution,
+            ItemIdx j,
+            Counter length,
+            const GlobalCost& c,
+            const Move& tabu)
+    {
+        AgentIdx i_old = solution.agents[j];
+        for (AgentIdx i: ejection_chain_agents_[j]) {
+            if (i == i_old)
+                continue;
+            if (j == tabu.j && i == tabu.i)
+                continue;
+            remove(solution, j);
+            add(solution, j, i);
+            ejection_chain_move_number_++;
+            modified_agents_.push_back(i);
+            if (global_cost(solution) < c)
+                return true;
+            if (length < parameters_.ejection_chain_maximum_length) {
+                // Eject an item from agent i.
+                ItemPos ejected_item_number = 0;
+                for (ItemIdx j_next: agent_items_[i]) {
+                    if (parameters_.ejection_chain_item_number > 0
+                            && ejected_item_number == parameters_.ejection_chain_item_number)
+                        break;
+                    if (solution.agents[j_next] != i)
+                        continue;
+                    ejected_item_number++;
+                    if (ejection_chain(solution, j_next, length + 1, c, tabu))
+                        return true;
+                }
+            }
+            modified_agents_.pop_back();
+            remove(solution, j);
+            add(solution, j, i_old);
+        }
+        return false;
+    }
+
+    /*
+     * Private attributes.
+     */
+
+    const Instance& instance_;
+    Parameters parameters_;
+
+    std::vector<ItemIdx> items_;
+    /** Move table: best shift move of each item and its global cost variation. */
+    std::vector<AgentIdx> move_agents_;
+    std::vector<GlobalCost> move_deltas_;
+    /** Agents modified by the last move. */
+    std::vector<AgentIdx> modified_agents_;
+    /** Threads evaluating the shift moves, NULL if single-threaded. */
+    std::unique_ptr<NeighborhoodThreads> neighborhood_threads_;
+    /** best_positions_[t]: position in items_ of the best move found by thread t. */
+    std::vector<ItemPos> best_positions_;
+    /** Buffer of the moves returned by perturbations(). */
+    mutable std::vector<Move> perturbations_;
+
+    /** agent_items_[i]: items assigned to agent i when the ejection chain search started. */
+    std::vector<std::vector<ItemIdx>> agent_items_;
+    /**
+     * candidate_agents_[j]: agents to which item j is moved; the candidate
+     * agents of the instance, or its candidate_agent_number cheapest eligible
+     * agents if restricted_candidate_agents_.
+     */
+    std::vector<std::vector<AgentIdx>> candidate_agents_;
+    bool restricted_candidate_agents_ = false;
+    /** ejection_chain_agents_[j]: cheapest candidate agents of item j. */
+    std::vector<std::vector<AgentIdx>> ejection_chain_agents_;
+    Counter ejection_chain_search_number_ = 0;
+    Counter ejection_chain_move_number_ = 0;
+    /** Number of bits per item in compact solutions. */
+    int bit_number_ = 1;
+
+};
+
 LocalSearchOutput localsearch(
         const Instance& instance,
         std::mt19937_64& generator,
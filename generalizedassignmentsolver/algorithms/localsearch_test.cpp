@@ -0,0 +1,307 @@
+#include "generalizedassignmentsolver/algorithms/localsearch.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace generalizedassignmentsolver;
+
+/** Random instance with n items, n / 5 agents and tight capacities. */
+Instance localsearch_instance_test(ItemIdx n, Seed seed)
+{
+    AgentIdx m = n / 5;
+    std::mt19937_64 generator(seed);
+    std::uniform_int_distribution<Weight> d_weight(5, 25);
+    std::uniform_int_distribution<Cost> d_cost(10, 50);
+    InstanceBuilder builder(n, m);
+    for (AgentIdx i = 0; i < m; ++i)
+        builder.set_capacity(i, 4 * 15);
+    for (ItemIdx j = 0; j < n; ++j)
+        for (AgentIdx i = 0; i < m; ++i)
+            builder.set_alternative(j, i, d_weight(generator), d_cost(generator));
+    return builder.build();
+}
+
+/** Average number of moves evaluated by an ejection chain search. */
+double localsearch_ejection_chain_move_number(ItemIdx n)
+{
+    Instance instance = localsearch_instance_test(n, 0);
+    LocalScheme local_scheme(instance, LocalScheme::Parameters());
+    std::mt19937_64 generator(0);
+    for (Counter s = 0; s < 4; ++s) {
+        LocalScheme::Solution solution = local_scheme.initial_solution(0, generator);
+        local_scheme.local_search(solution, generator);
+    }
+    EXPECT_GT(local_scheme.ejection_chain_search_number(), 0);
+    return (double)local_scheme.ejection_chain_move_number()
+        / local_scheme.ejection_chain_search_number();
+}
+
+TEST(LocalSearch, EjectionChainDefaultIsLinear)
+{
+    // With the default parameters, an ejection chain search evaluates at
+    // most n * k * (1 + s * k) moves, where k is the number of agents and s
+    // the number of items explored at each step.
+    LocalScheme::Parameters parameters;
+    double k = parameters.ejection_chain_agent_number;
+    double s = parameters.ejection_chain_item_number;
+    double move_number_1 = localsearch_ejection_chain_move_number(200);
+    double move_number_2 = localsearch_ejection_chain_move_number(800);
+    EXPECT_LE(move_number_1, 200 * k * (1 + s * k));
+    EXPECT_LE(move_number_2, 800 * k * (1 + s * k));
+    // The number of agents grows with the number of items; without the
+    // limits, the search would be more than cubic.
+    EXPECT_LE(move_number_2, 6 * move_number_1);
+}
+
+namespace generalizedassignmentsolver
+{
+
+/** Access to the private members of LocalScheme. */
+class LocalSchemeTest
+{
+
+public:
+
+    static void add(
+            const LocalScheme& local_scheme,
+            LocalScheme::Solution& solution,
+            ItemIdx j,
+            AgentIdx i)
+    {
+        local_scheme.add(solution, j, i);
+    }
+
+    static void remove(
+            const LocalScheme& local_scheme,
+            LocalScheme::Solution& solution,
+            ItemIdx j)
+    {
+        local_scheme.remove(solution, j);
+    }
+
+    /** Hash of the solution computed from its assignment. */
+    static uint64_t hash(
+            const LocalScheme& local_scheme,
+            const LocalScheme::Solution& solution)
+    {
+        uint64_t hash = 0;
+        for (ItemIdx j = 0; j < (ItemIdx)solution.agents.size(); ++j)
+            if (solution.agents[j] != -1)
+                hash ^= local_scheme.zobrist_key(j, solution.agents[j]);
+        return hash;
+    }
+
+    static LocalScheme::GlobalCost shift_delta(
+            const LocalScheme& local_scheme,
+            const LocalScheme::Solution& solution,
+            ItemIdx j,
+            AgentIdx i)
+    {
+        return local_scheme.shift_delta(solution, j, i);
+    }
+
+    /**
+     * Update the move table after a modification of the load of 'agents'
+     * (all the moves if it is empty) and return the item of the best
+     * improving move, as in a step of the descent.
+     */
+    static ItemIdx update_moves(
+            LocalScheme& local_scheme,
+            const LocalScheme::Solution& solution,
+            const std::vector<AgentIdx>& agents,
+            const LocalScheme::Move& tabu)
+    {
+        local_scheme.modified_agents_ = agents;
+        return local_scheme.update_moves(solution, tabu);
+    }
+
+    /** Recompute the best move of item j from scratch. */
+    static void evaluate_moves(
+            LocalScheme& local_scheme,
+            const LocalScheme::Solution& solution,
+            ItemIdx j,
+            const LocalScheme::Move& tabu)
+    {
+        local_scheme.evaluate_moves(solution, j, tabu);
+    }
+
+    static const std::vector<AgentIdx>& move_agents(const LocalScheme& local_scheme) { return local_scheme.move_agents_; }
+    static const std::vector<LocalScheme::GlobalCost>& move_deltas(const LocalScheme& local_scheme) { return local_scheme.move_deltas_; }
+
+};
+
+}
+
+/**
+ * Apply a random modification to the solution: unassign an item, assign an
+ * unassigned item, or move an item to another agent.
+ */
+void localsearch_random_modification(
+        const Instance& instance,
+        const LocalScheme& local_scheme,
+        LocalScheme::Solution& solution,
+        std::mt19937_64& generator)
+{
+    std::uniform_int_distribution<ItemIdx> d_item(0, instance.item_number() - 1);
+    std::uniform_int_distribution<AgentIdx> d_agent(0, instance.agent_number() - 1);
+    ItemIdx j = d_item(generator);
+    AgentIdx i = d_agent(generator);
+    if (solution.agents[j] == -1) {
+        LocalSchemeTest::add(local_scheme, solution, j, i);
+    } else if (i == solution.agents[j]) {
+        LocalSchemeTest::remove(local_scheme, solution, j);
+    } else {
+        local_scheme.apply_move(solution, {j, i, LocalScheme::global_cost_worst()});
+    }
+}
+
+TEST(LocalSearch, CompactSolutionRoundTrip)
+{
+    // 1, 3 and 4 bits per item, so that items straddle two words.
+    for (AgentIdx m: {1, 7, 8}) {
+        InstanceBuilder builder(100, m);
+        std::mt19937_64 generator(m);
+        for (AgentIdx i = 0; i < m; ++i)
+            builder.set_capacity(i, 100);
+        for (ItemIdx j = 0; j < 100; ++j)
+            for (AgentIdx i = 0; i < m; ++i)
+                builder.set_alternative(j, i, 1 + generator() % 10, generator() % 10);
+        Instance instance = builder.build();
+        LocalScheme local_scheme(instance, LocalScheme::Parameters());
+        LocalScheme::Solution solution = local_scheme.initial_solution(0, generator);
+        for (Counter it = 0; it < 200; ++it) {
+            localsearch_random_modification(instance, local_scheme, solution, generator);
+            LocalScheme::CompactSolution compact_solution = local_scheme.solution2compact(solution);
+            LocalScheme::Solution solution_2 = local_scheme.compact2solution(compact_solution);
+            ASSERT_EQ(solution_2.agents, solution.agents);
+            EXPECT_EQ(solution_2.weights, solution.weights);
+            EXPECT_EQ(solution_2.item_number, solution.item_number);
+            EXPECT_EQ(solution_2.overweight, solution.overweight);
+            EXPECT_EQ(solution_2.cost, solution.cost);
+            EXPECT_EQ(solution_2.hash, solution.hash);
+            EXPECT_TRUE(local_scheme.solution2compact(solution_2) == compact_solution);
+        }
+    }
+}
+
+TEST(LocalSearch, IncrementalHash)
+{
+    Instance instance = localsearch_instance_test(100, 0);
+    LocalScheme local_scheme(instance, LocalScheme::Parameters());
+    std::mt19937_64 generator(0);
+    LocalScheme::Solution solution = local_scheme.initial_solution(0, generator);
+    EXPECT_EQ(solution.hash, LocalSchemeTest::hash(local_scheme, solution));
+    for (Counter it = 0; it < 1000; ++it) {
+        localsearch_random_modification(instance, local_scheme, solution, generator);
+        ASSERT_EQ(solution.hash, LocalSchemeTest::hash(local_scheme, solution));
+    }
+    // A descent updates the hash through the same operations.
+    local_scheme.local_search(solution, generator);
+    EXPECT_EQ(solution.hash, LocalSchemeTest::hash(local_scheme, solution));
+}
+
+TEST(LocalSearch, IncrementalMoveTable)
+{
+    Instance instance = localsearch_instance_test(100, 0);
+    for (AgentPos candidate_agent_number: {0, 8}) {
+        LocalScheme::Parameters parameters;
+        parameters.candidate_agent_number = candidate_agent_number;
+        LocalScheme local_scheme(instance, parameters);
+        std::mt19937_64 generator(candidate_agent_number);
+        std::uniform_int_distribution<ItemIdx> d_item(0, instance.item_number() - 1);
+        std::uniform_int_distribution<AgentIdx> d_agent(0, instance.agent_number() - 1);
+        LocalScheme::Solution solution = local_scheme.initial_solution(0, generator);
+        LocalScheme::Move tabu = {d_item(generator), d_agent(generator), LocalScheme::global_cost_worst()};
+        LocalSchemeTest::update_moves(local_scheme, solution, {}, tabu);
+        for (Counter it = 0; it < 500; ++it) {
+            // Apply a random move and update the move table.
+            ItemIdx j_move = d_item(generator);
+            AgentIdx i_old = solution.agents[j_move];
+            AgentIdx i = d_agent(generator);
+            if (i == i_old)
+                continue;
+            local_scheme.apply_move(solution, {j_move, i, LocalScheme::global_cost_worst()});
+            ItemIdx j_best = LocalSchemeTest::update_moves(local_scheme, solution, {i_old, i}, tabu);
+            std::vector<AgentIdx> move_agents = LocalSchemeTest::move_agents(local_scheme);
+            std::vector<LocalScheme::GlobalCost> move_deltas = LocalSchemeTest::move_deltas(local_scheme);
+
+            // Compare it to a full rescan. Ties may be broken differently.
+            LocalScheme::GlobalCost d_best = {0, 0, 0};
+            for (ItemIdx j = 0; j < instance.item_number(); ++j) {
+                if (move_agents[j] != -1) {
+                    EXPECT_EQ(move_deltas[j], LocalSchemeTest::shift_delta(
+                                local_scheme, solution, j, move_agents[j]));
+                }
+                LocalSchemeTest::evaluate_moves(local_scheme, solution, j, tabu);
+                ASSERT_EQ(move_deltas[j], LocalSchemeTest::move_deltas(local_scheme)[j])
+                    << "it " << it << " item " << j;
+                d_best = std::min(d_best, move_deltas[j]);
+            }
+            if (j_best == -1) {
+                EXPECT_EQ(d_best, LocalScheme::GlobalCost(0, 0, 0));
+            } else {
+                EXPECT_EQ(move_deltas[j_best], d_best);
+            }
+        }
+    }
+}
+
+TEST(LocalSearch, NeighborhoodThreadsDeterministic)
+{
+    // The descent must not depend on the number of neighborhood threads.
+    // The order of the items is kept from one descent to the next, so both
+    // schemes must be used for the same sequence of descents.
+    Instance instance = localsearch_instance_test(200, 0);
+    for (Counter thread_number: {2, 3, 4}) {
+        LocalScheme local_scheme_1(instance, LocalScheme::Parameters());
+        LocalScheme::Parameters parameters;
+        parameters.neighborhood_thread_number = thread_number;
+        LocalScheme local_scheme_2(instance, parameters);
+        for (Seed seed = 0; seed < 4; ++seed) {
+            std::mt19937_64 generator_1(seed);
+            std::mt19937_64 generator_2(seed);
+            LocalScheme::Solution solution_1 = local_scheme_1.initial_solution(0, generator_1);
+            LocalScheme::Solution solution_2 = local_scheme_2.initial_solution(0, generator_2);
+            local_scheme_1.local_search(solution_1, generator_1);
+            local_scheme_2.local_search(solution_2, generator_2);
+            EXPECT_EQ(solution_1.agents, solution_2.agents)
+                << "threads " << thread_number << " seed " << seed;
+            EXPECT_EQ(solution_1.cost, solution_2.cost);
+            EXPECT_EQ(solution_1.overweight, solution_2.overweight);
+        }
+    }
+}
+
+TEST(LocalSearch, PerturbationsTopK)
+{
+    // The k best perturbations kept in a heap are the first k perturbations
+    // once all of them are sorted. Ties may be broken differently.
+    Instance instance = localsearch_instance_test(100, 0);
+    LocalScheme local_scheme(instance, LocalScheme::Parameters());
+    auto compare = [](const LocalScheme::Move& move_1, const LocalScheme::Move& move_2) -> bool
+    {
+        return move_1.global_cost < move_2.global_cost;
+    };
+    std::mt19937_64 generator(0);
+    for (Counter k: {1, 10, 100, 100000}) {
+        LocalScheme::Parameters parameters;
+        parameters.perturbation_number = k;
+        LocalScheme local_scheme_k(instance, parameters);
+        for (Counter s = 0; s < 4; ++s) {
+            LocalScheme::Solution solution = local_scheme.initial_solution(0, generator);
+            if (s % 2 == 1)
+                local_scheme.local_search(solution, generator);
+            std::vector<LocalScheme::Move> moves = local_scheme.perturbations(solution);
+            std::sort(moves.begin(), moves.end(), compare);
+            if ((Counter)moves.size() > k)
+                moves.resize(k);
+            const std::vector<LocalScheme::Move>& moves_k = local_scheme_k.perturbations(solution);
+            ASSERT_EQ(moves_k.size(), moves.size());
+            for (std::size_t pos = 0; pos < moves.size(); ++pos) {
+                EXPECT_EQ(moves_k[pos].global_cost, moves[pos].global_cost);
+                LocalScheme::Solution solution_k = solution;
+                local_scheme.apply_move(solution_k, moves_k[pos]);
+                EXPECT_EQ(local_scheme.global_cost(solution_k), moves_k[pos].global_cost);
+            }
+        }
+    }
+}
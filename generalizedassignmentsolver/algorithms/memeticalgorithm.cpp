@@ -0,0 +1,201 @@
+#include "generalizedassignmentsolver/algorithms/memeticalgorithm.hpp"
+
+#include "generalizedassignmentsolver/algorithms/penaltylocalsearch.hpp"
+#include "generalizedassignmentsolver/algorithms/random.hpp"
+#include "generalizedassignmentsolver/algorithms/repair.hpp"
+
+#include <random>
+#include <algorithm>
+#include <vector>
+#include <thread>
+
+using namespace generalizedassignmentsolver;
+
+MemeticAlgorithmOutput& MemeticAlgorithmOutput::algorithm_end(Info& info)
+{
+    PUT(info, "Algorithm", "Iterations", iterations);
+    PUT(info, "Algorithm", "Children", children);
+    Output::algorithm_end(info);
+    VER(info, "Iterations: " << iterations << std::endl);
+    VER(info, "Children: " << children << std::endl);
+    return *this;
+}
+
+/** Repair solution and improve it with penaltylocalsearch. */
+Solution memeticalgorithm_improve(
+        Solution& solution,
+        Seed seed,
+        const MemeticAlgorithmOptionalParameters& parameters)
+{
+    std::mt19937_64 generator(seed);
+    Info info_repair = Info().set_verbose(false);
+    info_repair.set_timelimit(parameters.info.remaining_time());
+    repair_shift_swap(solution, info_repair);
+
+    PenaltyLocalSearchOptionalParameters parameters_local_search;
+    parameters_local_search.info.set_verbose(false);
+    parameters_local_search.info.set_timelimit(parameters.info.remaining_time());
+    parameters_local_search.iteration_limit = parameters.local_search_iteration_limit;
+    parameters_local_search.initial_penalty = parameters.local_search_initial_penalty;
+    parameters_local_search.initial_solution = &solution;
+    auto output_local_search = penaltylocalsearch(
+            solution.instance(), generator, parameters_local_search);
+    return output_local_search.solution;
+}
+
+/** Breed a child of parent_1 and parent_2 and improve it. */
+Solution memeticalgorithm_child(
+        const Solution& parent_1,
+        const Solution& parent_2,
+        Seed seed,
+        const MemeticAlgorithmOptionalParameters& parameters)
+{
+    const Instance& instance = parent_1.instance();
+    std::mt19937_64 generator(seed);
+    std::bernoulli_distribution d_parent(0.5);
+    Solution child(instance);
+    for (ItemIdx j = 0; j < instance.item_number(); ++j)
+        child.set(j, (d_parent(generator))? parent_1.agent(j): parent_2.agent(j));
+    return memeticalgorithm_improve(child, generator(), parameters);
+}
+
+/**
+ * Insert child in the population; return false if it has been discarded.
+ */
+bool memeticalgorithm_insert(
+        std::vector<Solution>& population,
+        const Solution& child,
+        Counter population_size)
+{
+    if (!child.feasible())
+        return false;
+    Counter pos_replaced = -1;
+    ItemIdx d_replaced = -1;
+    for (Counter pos = 0; pos < (Counter)population.size(); ++pos) {
+        ItemIdx d = distance(child, population[pos]);
+        if (d == 0)
+            return false;
+        if (population[pos].cost() < child.cost())
+            continue;
+        if (d_replaced == -1 || d_replaced > d) {
+            d_replaced = d;
+            pos_replaced = pos;
+        }
+    }
+    if ((Counter)population.size() < population_size) {
+        population.push_back(child);
+    } else if (pos_replaced != -1) {
+        population[pos_replaced] = child;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+MemeticAlgorithmOutput generalizedassignmentsolver::memeticalgorithm(
+        const Instance& instance,
+        std::mt19937_64& generator,
+        MemeticAlgorithmOptionalParameters parameters)
+{
+    VER(parameters.info, "*** memeticalgorithm ***" << std::endl);
+    MemeticAlgorithmOutput output(instance, parameters.info);
+    Counter thread_number = std::max((Counter)1, parameters.thread_number);
+    Counter population_size = std::max((Counter)2, parameters.population_size);
+
+    // Initial population.
+    std::vector<Solution> population;
+    if (parameters.initial_solution != nullptr
+            && parameters.initial_solution->feasible()) {
+        population.push_back(*parameters.initial_solution);
+        output.update_solution(*parameters.initial_solution, std::stringstream("initial solution"), parameters.info);
+    }
+    std::vector<Solution> solutions;
+    std::vector<Seed> seeds;
+    for (Counter pos = population.size(); pos < population_size; ++pos) {
+        solutions.push_back(random_infeasible(instance, generator));
+        seeds.push_back(generator());
+    }
+    for (Counter pos_start = 0; pos_start < (Counter)solutions.size(); pos_start += thread_number) {
+        Counter pos_end = std::min(pos_start + thread_number, (Counter)solutions.size());
+        std::vector<std::thread> threads;
+        for (Counter pos = pos_start; pos < pos_end; ++pos) {
+            threads.push_back(std::thread(
+                        [&solutions, &seeds, &parameters, pos]()
+                        {
+                            solutions[pos] = memeticalgorithm_improve(
+                                    solutions[pos], seeds[pos], parameters);
+                        }));
+        }
+        for (std::thread& thread: threads)
+            thread.join();
+    }
+    for (const Solution& solution: solutions) {
+        if (memeticalgorithm_insert(population, solution, population_size))
+            output.update_solution(solution, std::stringstream("initial population"), parameters.info);
+    }
+    if (population.size() < 2)
+        return output.algorithm_end(parameters.info);
+
+    // Generations.
+    std::vector<Solution> children(thread_number, Solution(instance));
+    Counter iterations_without_improvement = 0;
+    for (output.iterations = 0; parameters.info.check_time(); ++output.iterations) {
+        if (parameters.iteration_limit != -1
+                && iterations_without_improvement >= parameters.iteration_limit)
+            break;
+
+        // Select the parents by binary tournaments.
+        std::uniform_int_distribution<Counter> d_pos(0, population.size() - 1);
+        auto tournament = [&population, &d_pos, &generator]()
+        {
+            Counter pos_1 = d_pos(generator);
+            Counter pos_2 = d_pos(generator);
+            return (population[pos_1].cost() <= population[pos_2].cost())? pos_1: pos_2;
+        };
+        std::vector<std::pair<Counter, Counter>> parents;
+        seeds.clear();
+        for (Counter t = 0; t < thread_number; ++t) {
+            Counter pos_1 = tournament();
+            Counter pos_2 = tournament();
+            parents.push_back({pos_1, pos_2});
+            seeds.push_back(generator());
+        }
+
+        // Breed and improve the children.
+        std::vector<std::thread> threads;
+        auto breed = [&population, &children, &parents, &seeds, &parameters](Counter t)
+        {
+            children[t] = memeticalgorithm_child(
+                    population[parents[t].first],
+                    population[parents[t].second],
+                    seeds[t],
+                    parameters);
+        };
+        for (Counter t = 1; t < thread_number; ++t)
+            threads.push_back(std::thread(breed, t));
+        breed(0);
+        for (std::thread& thread: threads)
+            thread.join();
+        output.children += thread_number;
+
+        // Update the population.
+        bool improved = false;
+        for (const Solution& child: children) {
+            if (!memeticalgorithm_insert(population, child, population_size))
+                continue;
+            if (!output.solution.feasible() || output.solution.cost() > child.cost()) {
+                improved = true;
+                std::stringstream ss;
+                ss << "generation " << output.iterations;
+                output.update_solution(child, ss, parameters.info);
+            }
+        }
+        if (improved) {
+            iterations_without_improvement = 0;
+        } else {
+            iterations_without_improvement++;
+        }
+    }
+
+    return output.algorithm_end(parameters.info);
+}
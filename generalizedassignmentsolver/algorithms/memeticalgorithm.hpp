@@ -0,0 +1,51 @@
+#pragma once
+
+#include "generalizedassignmentsolver/solution.hpp"
+
+namespace generalizedassignmentsolver
+{
+
+struct MemeticAlgorithmOptionalParameters
+{
+    Info info = Info();
+
+    /** Number of children bred and improved in parallel at each generation. */
+    Counter thread_number = 1;
+    /** Maximum number of generations without improvement; -1 for no limit. */
+    Counter iteration_limit = 100;
+    Counter population_size = 20;
+    /** Iteration limit of the local searches, see penaltylocalsearch. */
+    Counter local_search_iteration_limit = 100;
+    /** Initial penalty of a unit of overcapacity in the local searches. */
+    PCost local_search_initial_penalty = 30;
+    const Solution* initial_solution = nullptr;
+};
+
+struct MemeticAlgorithmOutput: Output
+{
+    MemeticAlgorithmOutput(const Instance& instance, Info& info): Output(instance, info) { }
+    MemeticAlgorithmOutput& algorithm_end(Info& info);
+
+    Counter iterations = 0;
+    Counter children = 0;
+};
+
+/**
+ * Memetic algorithm.
+ *
+ * The population is initialized with random solutions. At each generation,
+ * thread_number children are bred in parallel: their parents are selected by
+ * binary tournaments, each item is assigned to the agent of one of its
+ * parents drawn at random, then the child is repaired with
+ * repair_shift_swap and improved with penaltylocalsearch.
+ *
+ * A child identical to a solution of the population is discarded. Otherwise,
+ * it replaces, among the solutions of the population which are not better
+ * than it, the closest one, so that the population remains diverse.
+ */
+MemeticAlgorithmOutput memeticalgorithm(
+        const Instance& instance,
+        std::mt19937_64& generator,
+        MemeticAlgorithmOptionalParameters parameters = {});
+
+}
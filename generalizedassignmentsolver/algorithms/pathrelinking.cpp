@@ -0,0 +1,267 @@
+#include "generalizedassignmentsolver/algorithms/pathrelinking.hpp"
+
+#include "generalizedassignmentsolver/algorithms/penaltylocalsearch.hpp"
+#include "generalizedassignmentsolver/algorithms/random.hpp"
+
+#include <set>
+#include <random>
+#include <algorithm>
+#include <vector>
+#include <thread>
+#include <mutex>
+
+using namespace generalizedassignmentsolver;
+
+PathRelinkingOutput& PathRelinkingOutput::algorithm_end(Info& info)
+{
+    PUT(info, "Algorithm", "Iterations", iterations);
+    Output::algorithm_end(info);
+    VER(info, "Iterations: " << iterations << std::endl);
+    return *this;
+}
+
+/**
+ * Elite pool of path relinking.
+ *
+ * A feasible solution is inserted if it is not too close to a solution of
+ * the pool; then, if the pool is full, it replaces the worst solution if it
+ * is better. If it is too close to a solution of the pool, it replaces this
+ * solution if it is better.
+ */
+class PathRelinkingPool
+{
+
+public:
+
+    PathRelinkingPool(const PathRelinkingOptionalParameters& parameters):
+        parameters_(parameters) { }
+
+    Counter size() const { return solutions_.size(); }
+
+    bool add(const Solution& solution)
+    {
+        if (!solution.feasible())
+            return false;
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        Counter pos_closest = -1;
+        ItemIdx d_closest = -1;
+        Counter pos_worst = -1;
+        for (Counter pos = 0; pos < (Counter)solutions_.size(); ++pos) {
+            ItemIdx d = distance(solution, solutions_[pos]);
+            if (d_closest == -1 || d_closest > d) {
+                d_closest = d;
+                pos_closest = pos;
+            }
+            if (pos_worst == -1 || solutions_[pos_worst].cost() < solutions_[pos].cost())
+                pos_worst = pos;
+        }
+
+        if (d_closest == 0)
+            return false;
+        if (pos_closest != -1 && d_closest < parameters_.minimum_distance) {
+            if (solutions_[pos_closest].cost() <= solution.cost())
+                return false;
+            solutions_[pos_closest] = solution;
+        } else if ((Counter)solutions_.size() < parameters_.elite_size) {
+            solutions_.push_back(solution);
+        } else {
+            if (solutions_[pos_worst].cost() <= solution.cost())
+                return false;
+            solutions_[pos_worst] = solution;
+        }
+        return true;
+    }
+
+    /**
+     * Return a random solution of the pool and the solution of the pool the
+     * farthest from it.
+     */
+    std::pair<Solution, Solution> pair(std::mt19937_64& generator)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::uniform_int_distribution<Counter> d_pos(0, solutions_.size() - 1);
+        Counter pos_1 = d_pos(generator);
+        Counter pos_2 = -1;
+        ItemIdx d_max = -1;
+        for (Counter pos = 0; pos < (Counter)solutions_.size(); ++pos) {
+            ItemIdx d = distance(solutions_[pos_1], solutions_[pos]);
+            if (d_max < d) {
+                d_max = d;
+                pos_2 = pos;
+            }
+        }
+        return {solutions_[pos_1], solutions_[pos_2]};
+    }
+
+private:
+
+    const PathRelinkingOptionalParameters& parameters_;
+    std::vector<Solution> solutions_;
+    std::mutex mutex_;
+
+};
+
+/**
+ * Improve solution with penaltylocalsearch and return the best solution
+ * found.
+ */
+Solution pathrelinking_local_search(
+        const Solution& solution,
+        Seed seed,
+        Counter iteration_limit,
+        PCost initial_penalty,
+        const PathRelinkingOptionalParameters& parameters)
+{
+    std::mt19937_64 generator(seed);
+    PenaltyLocalSearchOptionalParameters parameters_local_search;
+    parameters_local_search.info.set_verbose(false);
+    parameters_local_search.info.set_timelimit(parameters.info.remaining_time());
+    parameters_local_search.iteration_limit = iteration_limit;
+    parameters_local_search.initial_penalty = initial_penalty;
+    parameters_local_search.initial_solution = &solution;
+    auto output_local_search = penaltylocalsearch(
+            solution.instance(), generator, parameters_local_search);
+    return output_local_search.solution;
+}
+
+void pathrelinking_worker(
+        PathRelinkingOutput& output,
+        PathRelinkingPool& pool,
+        Seed seed,
+        PathRelinkingOptionalParameters& parameters,
+        std::mutex& mutex)
+{
+    const Instance& instance = output.solution.instance();
+    std::mt19937_64 generator(seed);
+    for (;;) {
+        Counter it = 0;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!parameters.info.check_time())
+                break;
+            if (parameters.iteration_limit != -1
+                    && output.iterations >= parameters.iteration_limit)
+                break;
+            it = output.iterations++;
+        }
+
+        auto solutions = pool.pair(generator);
+        Solution& solution = solutions.first;
+        const Solution& solution_guiding = solutions.second;
+        std::vector<ItemIdx> items;
+        for (ItemIdx j = 0; j < instance.item_number(); ++j)
+            if (solution.agent(j) != solution_guiding.agent(j))
+                items.push_back(j);
+        ItemIdx path_length = items.size();
+
+        for (ItemIdx step = 1; step < path_length; ++step) {
+            // Move the item whose move to its guiding agent increases the
+            // overcapacity the least, then the cost the least.
+            ItemPos pos_best = -1;
+            Weight doc_best = 0;
+            Cost dc_best = 0;
+            for (ItemPos pos = 0; pos < (ItemPos)items.size(); ++pos) {
+                ItemIdx j = items[pos];
+                AgentIdx i_old = solution.agent(j);
+                AgentIdx i = solution_guiding.agent(j);
+                Weight doc = solution.overcapacity_delta(i_old, -instance.weight(j, i_old))
+                    + solution.overcapacity_delta(i, instance.weight(j, i));
+                Cost dc = instance.cost(j, i) - instance.cost(j, i_old);
+                if (pos_best == -1
+                        || doc_best > doc
+                        || (doc_best == doc && dc_best > dc)) {
+                    pos_best = pos;
+                    doc_best = doc;
+                    dc_best = dc;
+                }
+            }
+            ItemIdx j = items[pos_best];
+            solution.set(j, solution_guiding.agent(j));
+            items[pos_best] = items.back();
+            items.pop_back();
+
+            // Improve some intermediate solutions.
+            Counter k = parameters.local_search_number;
+            if (step * (k + 1) / path_length != (step - 1) * (k + 1) / path_length) {
+                Solution solution_improved = pathrelinking_local_search(
+                        solution,
+                        generator(),
+                        parameters.local_search_iteration_limit,
+                        parameters.local_search_initial_penalty,
+                        parameters);
+                if (pool.add(solution_improved)) {
+                    std::stringstream ss;
+                    ss << "path " << it << " step " << step;
+                    output.update_solution(solution_improved, ss, parameters.info);
+                }
+            }
+        }
+    }
+}
+
+PathRelinkingOutput generalizedassignmentsolver::pathrelinking(
+        const Instance& instance,
+        std::mt19937_64& generator,
+        PathRelinkingOptionalParameters parameters)
+{
+    VER(parameters.info, "*** pathrelinking ***" << std::endl);
+    PathRelinkingOutput output(instance, parameters.info);
+    PathRelinkingPool pool(parameters);
+    Counter thread_number = std::max((Counter)1, parameters.thread_number);
+
+    // Build the initial pool.
+    if (parameters.initial_solution != nullptr
+            && parameters.initial_solution->feasible()) {
+        pool.add(*parameters.initial_solution);
+        output.update_solution(*parameters.initial_solution, std::stringstream("initial solution"), parameters.info);
+    }
+    std::vector<Solution> initial_solutions;
+    std::vector<Seed> seeds;
+    for (Counter pos = 0; pos < parameters.elite_size; ++pos) {
+        initial_solutions.push_back(random_infeasible(instance, generator));
+        seeds.push_back(generator());
+    }
+    std::vector<Solution> solutions(parameters.elite_size, Solution(instance));
+    for (Counter pos_start = 0; pos_start < parameters.elite_size; pos_start += thread_number) {
+        Counter pos_end = std::min(pos_start + thread_number, parameters.elite_size);
+        std::vector<std::thread> threads;
+        for (Counter pos = pos_start; pos < pos_end; ++pos) {
+            threads.push_back(std::thread(
+                        [&solutions, &initial_solutions, &seeds, &parameters, pos]()
+                        {
+                            solutions[pos] = pathrelinking_local_search(
+                                    initial_solutions[pos],
+                                    seeds[pos],
+                                    parameters.pool_iteration_limit,
+                                    PenaltyLocalSearchOptionalParameters().initial_penalty,
+                                    parameters);
+                        }));
+        }
+        for (std::thread& thread: threads)
+            thread.join();
+    }
+    for (const Solution& solution: solutions) {
+        if (pool.add(solution))
+            output.update_solution(solution, std::stringstream("initial pool"), parameters.info);
+    }
+    if (pool.size() < 2)
+        return output.algorithm_end(parameters.info);
+
+    // Relink pairs of solutions.
+    std::mutex mutex;
+    std::vector<std::thread> threads;
+    for (Counter t = 1; t < thread_number; ++t)
+        threads.push_back(std::thread(
+                    pathrelinking_worker,
+                    std::ref(output),
+                    std::ref(pool),
+                    generator(),
+                    std::ref(parameters),
+                    std::ref(mutex)));
+    pathrelinking_worker(output, pool, generator(), parameters, mutex);
+    for (std::thread& thread: threads)
+        thread.join();
+
+    return output.algorithm_end(parameters.info);
+}
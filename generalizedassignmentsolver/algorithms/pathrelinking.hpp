@@ -0,0 +1,67 @@
+#pragma once
+
+#include "generalizedassignmentsolver/solution.hpp"
+
+namespace generalizedassignmentsolver
+{
+
+struct PathRelinkingOptionalParameters
+{
+    Info info = Info();
+
+    Counter thread_number = 1;
+    /** Maximum number of paths; -1 for no limit. */
+    Counter iteration_limit = 200;
+    /** Size of the elite pool. */
+    Counter elite_size = 10;
+    /**
+     * Iteration limit of the local searches building the elite pool from
+     * random solutions, see penaltylocalsearch.
+     */
+    Counter pool_iteration_limit = 1000;
+    /** Minimum distance between two solutions of the elite pool. */
+    ItemIdx minimum_distance = 5;
+    /** Number of intermediate solutions improved by local search on each path. */
+    Counter local_search_number = 3;
+    /** Iteration limit of these local searches, see penaltylocalsearch. */
+    Counter local_search_iteration_limit = 100;
+    /**
+     * Initial penalty of a unit of overcapacity in these local searches;
+     * intermediate solutions are close to feasible, a high penalty restores
+     * feasibility quickly.
+     */
+    PCost local_search_initial_penalty = 30;
+    const Solution* initial_solution = nullptr;
+};
+
+struct PathRelinkingOutput: Output
+{
+    PathRelinkingOutput(const Instance& instance, Info& info): Output(instance, info) { }
+    PathRelinkingOutput& algorithm_end(Info& info);
+
+    Counter iterations = 0;
+};
+
+/**
+ * Path relinking.
+ *
+ * An elite pool of diverse feasible solutions is built with
+ * penaltylocalsearch from random solutions. Then, an initiating solution is
+ * drawn from the pool, and the guiding solution is the solution of the pool
+ * the farthest from it. The path between them moves, at each step, the item
+ * whose move to its agent in the guiding solution is the best. Some
+ * intermediate solutions are improved with penaltylocalsearch and the
+ * results are inserted in the pool if they are good and far enough from its
+ * solutions.
+ *
+ * The threads relink different pairs of solutions. They share the pool,
+ * which is locked, and report the improved solutions to the output directly,
+ * since Output::update_solution compares them with the incumbent under its
+ * lock.
+ */
+PathRelinkingOutput pathrelinking(
+        const Instance& instance,
+        std::mt19937_64& generator,
+        PathRelinkingOptionalParameters parameters = {});
+
+}
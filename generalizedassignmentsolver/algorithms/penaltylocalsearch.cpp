@@ -0,0 +1,244 @@
+#include "generalizedassignmentsolver/algorithms/penaltylocalsearch.hpp"
+
+#include "generalizedassignmentsolver/algorithms/random.hpp"
+
+#include <set>
+#include <random>
+#include <algorithm>
+#include <vector>
+#include <thread>
+
+using namespace generalizedassignmentsolver;
+
+PenaltyLocalSearchOutput& PenaltyLocalSearchOutput::algorithm_end(Info& info)
+{
+    PUT(info, "Algorithm", "Iterations", iterations);
+    Output::algorithm_end(info);
+    VER(info, "Iterations: " << iterations << std::endl);
+    return *this;
+}
+
+PenalizedSolution::PenalizedSolution(
+        const Solution& solution,
+        PCost initial_penalty,
+        AgentPos swap_agent_number):
+    instance_(solution.instance()),
+    solution_(solution),
+    agent_items_(instance_.agent_number()),
+    positions_(instance_.item_number(), -1),
+    swap_agents_(instance_.item_number())
+{
+    assert(solution.full());
+    for (ItemIdx j = 0; j < instance_.item_number(); ++j) {
+        AgentIdx i = solution_.agent(j);
+        positions_[j] = agent_items_[i].size();
+        agent_items_[i].push_back(j);
+    }
+    for (ItemIdx j = 0; j < instance_.item_number(); ++j) {
+        auto agents = instance_.candidate_agents(j);
+        std::vector<AgentIdx>& swap_agents = swap_agents_[j];
+        swap_agents.assign(agents.begin(), agents.end());
+        AgentPos k = swap_agent_number;
+        if (k > 0 && (AgentPos)swap_agents.size() > k) {
+            std::nth_element(
+                    swap_agents.begin(),
+                    swap_agents.begin() + k - 1,
+                    swap_agents.end(),
+                    [this, j](AgentIdx i1, AgentIdx i2) -> bool
+                    {
+                        return instance_.cost(j, i1) < instance_.cost(j, i2);
+                    });
+            swap_agents.resize(k);
+        }
+    }
+    solution_.update_penalties(std::vector<PCost>(
+                instance_.agent_number(), initial_penalty));
+}
+
+void PenalizedSolution::move(ItemIdx j, AgentIdx i)
+{
+    AgentIdx i_old = solution_.agent(j);
+    ItemIdx j_last = agent_items_[i_old].back();
+    agent_items_[i_old][positions_[j]] = j_last;
+    positions_[j_last] = positions_[j];
+    agent_items_[i_old].pop_back();
+    positions_[j] = agent_items_[i].size();
+    agent_items_[i].push_back(j);
+    solution_.set(j, i);
+}
+
+void PenalizedSolution::apply(const PenalizedMove& move)
+{
+    AgentIdx i1 = solution_.agent(move.j1);
+    this->move(move.j1, move.i);
+    if (move.j2 != -1)
+        this->move(move.j2, i1);
+}
+
+/** Trajectory of a thread of penaltylocalsearch. */
+class PenaltyLocalSearch
+{
+
+public:
+
+    PenaltyLocalSearch(
+            const Solution& solution,
+            PenaltyLocalSearchOptionalParameters& parameters):
+        instance_(solution.instance()),
+        parameters_(parameters),
+        solution_(solution, parameters.initial_penalty, parameters.swap_agent_number),
+        items_(instance_.item_number())
+    {
+        std::iota(items_.begin(), items_.end(), 0);
+    }
+
+    const Solution& solution() const { return solution_.solution(); }
+
+    /** Run a descent, then update the penalties. */
+    void iteration(std::mt19937_64& generator)
+    {
+        descent(generator);
+        solution_.update_penalties(
+                solution().overcapacity() > 0,
+                parameters_.delta_inc,
+                parameters_.delta_dec);
+    }
+
+private:
+
+    /**
+     * For each item, apply its best shift or swap move if it decreases the
+     * penalized cost, until no item has such a move.
+     */
+    void descent(std::mt19937_64& generator)
+    {
+        const PCost tolerance = 1e-9;
+        bool improved = true;
+        while (improved && parameters_.info.check_time()) {
+            improved = false;
+            std::shuffle(items_.begin(), items_.end(), generator);
+            for (ItemIdx j1: items_) {
+                AgentIdx i1 = solution().agent(j1);
+                PCost d_best = -tolerance;
+                PenalizedMove move_best;
+                for (AgentIdx i2: instance_.candidate_agents(j1)) {
+                    if (i2 == i1)
+                        continue;
+                    // Shift j1 to i2.
+                    PenalizedMove move = solution_.shift(j1, i2);
+                    PCost d = solution_.pcost(move);
+                    if (d < d_best) {
+                        d_best = d;
+                        move_best = move;
+                    }
+                }
+                for (AgentIdx i2: solution_.swap_agents(j1)) {
+                    if (i2 == i1)
+                        continue;
+                    // Swap j1 with an item j2 of agent i2.
+                    for (ItemIdx j2: solution_.agent_items(i2)) {
+                        if (!instance_.candidate(j2, i1))
+                            continue;
+                        PenalizedMove move = solution_.swap(j1, j2);
+                        PCost d = solution_.pcost(move);
+                        if (d < d_best) {
+                            d_best = d;
+                            move_best = move;
+                        }
+                    }
+                }
+                if (move_best.j1 == -1)
+                    continue;
+                solution_.apply(move_best);
+                improved = true;
+            }
+        }
+    }
+
+    const Instance& instance_;
+    const PenaltyLocalSearchOptionalParameters& parameters_;
+
+    PenalizedSolution solution_;
+    std::vector<ItemIdx> items_;
+
+};
+
+void penaltylocalsearch_worker(
+        PenaltyLocalSearchOutput& output,
+        const Solution& initial_solution,
+        Seed seed,
+        PenaltyLocalSearchOptionalParameters& parameters,
+        Counter& iterations)
+{
+    std::mt19937_64 generator(seed);
+    PenaltyLocalSearch local_search(initial_solution, parameters);
+    Cost cost_best = -1;
+    Counter iterations_without_improvement = 0;
+    for (iterations = 0; parameters.info.check_time(); ++iterations) {
+        if (parameters.iteration_limit != -1
+                && iterations_without_improvement >= parameters.iteration_limit)
+            break;
+        local_search.iteration(generator);
+        const Solution& solution = local_search.solution();
+        if (solution.feasible()
+                && (cost_best == -1 || cost_best > solution.cost())) {
+            cost_best = solution.cost();
+            iterations_without_improvement = 0;
+            std::stringstream ss;
+            ss << "it " << iterations;
+            output.update_solution(solution, ss, parameters.info);
+        } else {
+            iterations_without_improvement++;
+        }
+    }
+}
+
+PenaltyLocalSearchOutput generalizedassignmentsolver::penaltylocalsearch(
+        const Instance& instance,
+        std::mt19937_64& generator,
+        PenaltyLocalSearchOptionalParameters parameters)
+{
+    VER(parameters.info, "*** penaltylocalsearch ***" << std::endl);
+    PenaltyLocalSearchOutput output(instance, parameters.info);
+
+    // Initial solutions: the given one if it is complete, otherwise each item
+    // is assigned to its cheapest agent; the other threads start from random
+    // solutions.
+    Counter thread_number = std::max((Counter)1, parameters.thread_number);
+    std::vector<Solution> initial_solutions;
+    std::vector<Seed> seeds;
+    for (Counter t = 0; t < thread_number; ++t) {
+        if (t == 0) {
+            Solution solution(instance);
+            if (parameters.initial_solution != nullptr
+                    && parameters.initial_solution->full()) {
+                solution = *parameters.initial_solution;
+            } else {
+                for (ItemIdx j = 0; j < instance.item_number(); ++j)
+                    solution.set(j, instance.item(j).i_cmin);
+            }
+            initial_solutions.push_back(solution);
+        } else {
+            initial_solutions.push_back(random_infeasible(instance, generator));
+        }
+        seeds.push_back(generator());
+    }
+
+    std::vector<Counter> iterations(thread_number, 0);
+    std::vector<std::thread> threads;
+    for (Counter t = 1; t < thread_number; ++t)
+        threads.push_back(std::thread(
+                    penaltylocalsearch_worker,
+                    std::ref(output),
+                    std::ref(initial_solutions[t]),
+                    seeds[t],
+                    std::ref(parameters),
+                    std::ref(iterations[t])));
+    penaltylocalsearch_worker(output, initial_solutions[0], seeds[0], parameters, iterations[0]);
+    for (std::thread& thread: threads)
+        thread.join();
+
+    for (Counter it: iterations)
+        output.iterations += it;
+    return output.algorithm_end(parameters.info);
+}
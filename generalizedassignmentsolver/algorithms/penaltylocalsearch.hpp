@@ -0,0 +1,158 @@
+#pragma once
+
+#include "generalizedassignmentsolver/solution.hpp"
+
+namespace generalizedassignmentsolver
+{
+
+/**
+ * Shift or swap move: item j1 is moved to agent i and, if j2 != -1, item j2
+ * of agent i is moved to the agent of j1.
+ *
+ * doc1 and doc2 are the overcapacity variations of the agent of j1 and of
+ * agent i, and dc the cost variation; they remain valid as long as the loads
+ * of these two agents do not change.
+ */
+struct PenalizedMove
+{
+    ItemIdx j1 = -1;
+    AgentIdx i = -1;
+    ItemIdx j2 = -1;
+    Weight doc1 = 0;
+    Weight doc2 = 0;
+    Cost dc = 0;
+};
+
+/**
+ * Solution of a local search in which the capacity constraints can be
+ * violated, with the items assigned to each agent to enumerate swap moves.
+ * Used by penaltylocalsearch and tabusearch.
+ *
+ * The swaps of an item only consider the items of its swap_agent_number
+ * cheapest candidate agents (all of them if 0). The initial solution must
+ * assign every item.
+ */
+class PenalizedSolution
+{
+
+public:
+
+    PenalizedSolution(
+            const Solution& solution,
+            PCost initial_penalty,
+            AgentPos swap_agent_number);
+
+    const Solution& solution() const { return solution_; }
+
+    /** Items assigned to agent i. */
+    const std::vector<ItemIdx>& agent_items(AgentIdx i) const { return agent_items_[i]; }
+
+    /** Agents whose items may be swapped with item j. */
+    const std::vector<AgentIdx>& swap_agents(ItemIdx j) const { return swap_agents_[j]; }
+
+    inline PenalizedMove shift(ItemIdx j1, AgentIdx i) const
+    {
+        AgentIdx i1 = solution_.agent(j1);
+        PenalizedMove move;
+        move.j1 = j1;
+        move.i = i;
+        move.doc1 = solution_.overcapacity_delta(i1, -instance_.weight(j1, i1));
+        move.doc2 = solution_.overcapacity_delta(i, instance_.weight(j1, i));
+        move.dc = instance_.cost(j1, i) - instance_.cost(j1, i1);
+        return move;
+    }
+
+    inline PenalizedMove swap(ItemIdx j1, ItemIdx j2) const
+    {
+        AgentIdx i1 = solution_.agent(j1);
+        AgentIdx i2 = solution_.agent(j2);
+        PenalizedMove move;
+        move.j1 = j1;
+        move.i = i2;
+        move.j2 = j2;
+        move.doc1 = solution_.overcapacity_delta(i1, instance_.weight(j2, i1) - instance_.weight(j1, i1));
+        move.doc2 = solution_.overcapacity_delta(i2, instance_.weight(j1, i2) - instance_.weight(j2, i2));
+        move.dc = instance_.cost(j1, i2) + instance_.cost(j2, i1)
+            - instance_.cost(j1, i1) - instance_.cost(j2, i2);
+        return move;
+    }
+
+    /** Penalized cost variation of a move. */
+    inline PCost pcost(const PenalizedMove& move) const
+    {
+        return move.dc
+            + solution_.penalty(solution_.agent(move.j1)) * move.doc1
+            + solution_.penalty(move.i) * move.doc2;
+    }
+
+    /** Move item j to agent i. */
+    void move(ItemIdx j, AgentIdx i);
+
+    void apply(const PenalizedMove& move);
+
+    void update_penalties(bool inc, PCost delta_inc, PCost delta_dec)
+    {
+        solution_.update_penalties(inc, delta_inc, delta_dec);
+    }
+
+private:
+
+    const Instance& instance_;
+    Solution solution_;
+    /** agent_items_[i]: items assigned to agent i. */
+    std::vector<std::vector<ItemIdx>> agent_items_;
+    /** positions_[j]: position of item j in agent_items_[solution_.agent(j)]. */
+    std::vector<ItemPos> positions_;
+    /** swap_agents_[j]: agents whose items may be swapped with item j. */
+    std::vector<std::vector<AgentIdx>> swap_agents_;
+
+};
+
+struct PenaltyLocalSearchOptionalParameters
+{
+    Info info = Info();
+
+    Counter thread_number = 1;
+    /**
+     * Maximum number of iterations without improvement of the best solution
+     * of a thread; -1 for no limit.
+     */
+    Counter iteration_limit = 1000;
+    /** Initial penalty of a unit of overcapacity. */
+    PCost initial_penalty = 1;
+    /** Penalty update parameters, see Solution::update_penalties. */
+    PCost delta_inc = 0.1;
+    PCost delta_dec = 0.1;
+    /**
+     * Number of cheapest candidate agents of an item whose items are swapped
+     * with it; 0 for all of them.
+     */
+    AgentPos swap_agent_number = 8;
+    const Solution* initial_solution = nullptr;
+};
+
+struct PenaltyLocalSearchOutput: Output
+{
+    PenaltyLocalSearchOutput(const Instance& instance, Info& info): Output(instance, info) { }
+    PenaltyLocalSearchOutput& algorithm_end(Info& info);
+
+    Counter iterations = 0;
+};
+
+/**
+ * Local search in which the capacity constraints can be violated.
+ *
+ * The penalized cost of a solution is its cost plus, for each agent, its
+ * overcapacity times the penalty of the agent. A descent with shift and swap
+ * moves minimizes the penalized cost; then, the penalties of the agents are
+ * increased if the local optimum is infeasible and decreased otherwise, and
+ * the next descent starts from the same solution.
+ *
+ * The threads run independent trajectories.
+ */
+PenaltyLocalSearchOutput penaltylocalsearch(
+        const Instance& instance,
+        std::mt19937_64& generator,
+        PenaltyLocalSearchOptionalParameters parameters = {});
+
+}
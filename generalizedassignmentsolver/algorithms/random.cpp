@@ -11,10 +11,19 @@ Solution generalizedassignmentsolver::random_infeasible(
         const Instance& instance,
         std::mt19937_64& generator)
 {
-    std::uniform_int_distribution<> dis(0, instance.agent_number() - 1);
     Solution solution(instance);
-    for (ItemIdx j=0; j<instance.item_number(); ++j)
-        solution.set(j, dis(generator));
+    for (ItemIdx j=0; j<instance.item_number(); ++j) {
+        // Draw among the eligible agents, or among all the agents if the
+        // item does not fit anywhere.
+        auto agents = instance.eligible_agents(j);
+        if (agents.empty()) {
+            std::uniform_int_distribution<AgentIdx> dis(0, instance.agent_number() - 1);
+            solution.set(j, dis(generator));
+        } else {
+            std::uniform_int_distribution<AgentPos> dis(0, agents.size() - 1);
+            solution.set(j, agents[dis(generator)]);
+        }
+    }
     return solution;
 }
 
@@ -34,6 +43,8 @@ Output generalizedassignmentsolver::random(
     std::uniform_int_distribution<ItemIdx> dis_j2(0, n - 2);
     std::uniform_int_distribution<AgentIdx> dis_i(0, m - 2);
     std::uniform_real_distribution<double> dis(0, 1);
+    // If candidate lists are set, only move items to their candidate agents.
+    bool candidates = (instance.candidate_agent_number() > 0);
 
     Counter it_max = 2 * (n * m + (n * (n + 1)) / 2);
     Counter it_without_change = 0;
@@ -42,10 +53,23 @@ Output generalizedassignmentsolver::random(
         Counter p = dis_ss(generator);
         if (p <= m * n) { // shift
             ItemIdx j = dis_j(generator);
-            AgentIdx i = dis_i(generator);
             AgentIdx i_old = solution.agent(j);
-            if (i >= i_old)
-                i++;
+            AgentIdx i = -1;
+            if (candidates) {
+                auto agents = instance.candidate_agents(j);
+                if (agents.empty() || (agents.size() == 1 && agents[0] == i_old)) {
+                    it_without_change++;
+                    continue;
+                }
+                std::uniform_int_distribution<AgentPos> dis_i_pos(0, agents.size() - 1);
+                do {
+                    i = agents[dis_i_pos(generator)];
+                } while (i == i_old);
+            } else {
+                i = dis_i(generator);
+                if (i >= i_old)
+                    i++;
+            }
             if (std::max((Weight)0, solution.weight(i_old) - instance.weight(j, i_old) - instance.capacity(i_old))
                     + std::max((Weight)0, solution.weight(i) + instance.weight(j, i) - instance.capacity(i))
                     <= solution.overcapacity(i_old) + solution.overcapacity(i)) {
@@ -63,6 +87,10 @@ Output generalizedassignmentsolver::random(
             AgentIdx i2 = solution.agent(j2);
             if (i1 == i2)
                 continue;
+            if (candidates && (!instance.candidate(j1, i2) || !instance.candidate(j2, i1))) {
+                it_without_change++;
+                continue;
+            }
             if (std::max((Weight)0, solution.weight(i1) - instance.weight(j1, i1) + instance.weight(j2, i1) - instance.capacity(i1))
                     + std::max((Weight)0, solution.weight(i2) - instance.weight(j2, i2) + instance.weight(j1, i2) - instance.capacity(i2))
                     <= solution.overcapacity(i1) + solution.overcapacity(i2)) {
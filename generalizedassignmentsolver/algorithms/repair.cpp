@@ -37,6 +37,76 @@ std::istream& generalizedassignmentsolver::operator>>(std::istream& in, RepairIn
     return in;
 }
 
+void generalizedassignmentsolver::repair_shift_swap(
+        Solution& solution,
+        Info& info)
+{
+    const Instance& instance = solution.instance();
+    ItemIdx n = instance.item_number();
+    // If candidate lists are set, only move items to their candidate agents.
+    bool candidates = (instance.candidate_agent_number() > 0);
+
+    while (solution.overcapacity() > 0 && info.check_time()) {
+        ItemIdx j1_best = -1;
+        ItemIdx j2_best = -1;
+        ItemIdx i1_best = -1;
+        ItemIdx i2_best = -1;
+        double v_best = -1;
+        for (ItemIdx j1 = 0; j1 < n; ++j1) {
+            AgentIdx i1 = solution.agent(j1);
+            if (i1 == -1)
+                continue;
+
+            // Shift
+            for (AgentIdx i: instance.candidate_agents(j1)) {
+                if (i == i1)
+                    continue;
+                Weight diff = solution.overcapacity(i1) + solution.overcapacity(i)
+                    - std::max((Weight)0, solution.weight(i1) - instance.weight(j1, i1) - instance.capacity(i1))
+                    - std::max((Weight)0, solution.weight(i) + instance.weight(j1, i) - instance.capacity(i));
+                if (diff > 0) {
+                    double v = (double)(instance.cost(j1, i) - instance.cost(j1, i1)) / diff;
+                    if (j1_best < 0 || v_best > v) {
+                        v_best = v;
+                        j1_best = j1;
+                        i1_best = i;
+                        j2_best = -1;
+                    }
+                }
+            }
+
+            // Swap
+            for (ItemIdx j2 = j1 + 1; j2 < n; ++j2) {
+                AgentIdx i2 = solution.agent(j2);
+                if (i2 == i1 || i2 == -1)
+                    continue;
+                if (candidates && (!instance.candidate(j1, i2) || !instance.candidate(j2, i1)))
+                    continue;
+                Weight diff = solution.overcapacity(i1) + solution.overcapacity(i2)
+                    - std::max((Weight)0, solution.weight(i1) - instance.weight(j1, i1) + instance.weight(j2, i1) - instance.capacity(i1))
+                    - std::max((Weight)0, solution.weight(i2) - instance.weight(j2, i2) + instance.weight(j1, i2) - instance.capacity(i2));
+                if (diff > 0) {
+                    double v = (double)(instance.cost(j1, i2) + instance.cost(j2, i1)
+                            - instance.cost(j1, i1) - instance.cost(j2, i2)) / diff;
+                    if (j1_best < 0 || v_best > v) {
+                        v_best = v;
+                        j1_best = j1;
+                        j2_best = j2;
+                        i1_best = i2;
+                        i2_best = i1;
+                    }
+                }
+            }
+        }
+
+        if (j1_best == -1)
+            break;
+        solution.set(j1_best, i1_best);
+        if (j2_best != -1)
+            solution.set(j2_best, i2_best);
+    }
+}
+
 Output generalizedassignmentsolver::repair(
         const Instance& instance,
         std::mt19937_64& generator,
@@ -46,6 +116,8 @@ Output generalizedassignmentsolver::repair(
 
     AgentIdx m = instance.agent_number();
     ItemIdx  n = instance.item_number();
+    // If candidate lists are set, only move items to their candidate agents.
+    bool candidates = (instance.candidate_agent_number() > 0);
 
     Solution solution(instance);
     switch (parameters.initial_solution) {
@@ -109,64 +181,7 @@ Output generalizedassignmentsolver::repair(
     }
 
     if (parameters.l == -1) {
-        while (solution.overcapacity() > 0 && parameters.info.check_time()) {
-            //std::cout << "cost " << solution.cost() << " oc " << solution.overcapacity() << std::endl;
-            ItemIdx j1_best = -1;
-            ItemIdx j2_best = -1;
-            ItemIdx i1_best = -1;
-            ItemIdx i2_best = -1;
-            double v_best = -1;
-            for (ItemIdx j1 = 0; j1 < n; ++j1) {
-                AgentIdx i1 = solution.agent(j1);
-                if (i1 == -1)
-                    continue;
-
-                // Shift
-                for (AgentIdx i = 0; i < m; ++i) {
-                    if (i == i1)
-                        continue;
-                    Weight diff = solution.overcapacity(i1) + solution.overcapacity(i)
-                        - std::max((Weight)0, solution.weight(i1) - instance.weight(j1, i1) - instance.capacity(i1))
-                        - std::max((Weight)0, solution.weight(i) + instance.weight(j1, i) - instance.capacity(i));
-                    if (diff > 0) {
-                        double v = (double)(instance.cost(j1, i) - instance.cost(j1, i1)) / diff;
-                        if (j1_best < 0 || v_best > v) {
-                            v_best = v;
-                            j1_best = j1;
-                            i1_best = i;
-                            j2_best = -1;
-                        }
-                    }
-                }
-
-                // Swap
-                for (ItemIdx j2 = j1 + 1; j2 < n; ++j2) {
-                    AgentIdx i2 = solution.agent(j2);
-                    if (i2 == i1 || i2 == -1)
-                        continue;
-                    Weight diff = solution.overcapacity(i1) + solution.overcapacity(i2)
-                        - std::max((Weight)0, solution.weight(i1) - instance.weight(j1, i1) + instance.weight(j2, i1) - instance.capacity(i1))
-                        - std::max((Weight)0, solution.weight(i2) - instance.weight(j2, i2) + instance.weight(j1, i2) - instance.capacity(i2));
-                    if (diff > 0) {
-                        double v = (double)(instance.cost(j1, i2) + instance.cost(j2, i1)
-                                - instance.cost(j1, i1) - instance.cost(j2, i2)) / diff;
-                        if (j1_best < 0 || v_best > v) {
-                            v_best = v;
-                            j1_best = j1;
-                            j2_best = j2;
-                            i1_best = i2;
-                            i2_best = i1;
-                        }
-                    }
-                }
-            }
-
-            if (j1_best == -1)
-                break;
-            solution.set(j1_best, i1_best);
-            if (j2_best != -1)
-                solution.set(j2_best, i2_best);
-        }
+        repair_shift_swap(solution, parameters.info);
     } else {
         std::uniform_int_distribution<Counter> dis_ss(1, n * m + (n * (n + 1)) / 2);
         std::uniform_int_distribution<ItemIdx> dis_j(0, n - 1);
@@ -184,10 +199,21 @@ Output generalizedassignmentsolver::repair(
             Counter x = dis_ss(generator);
             if (x <= m * n) { // shift
                 ItemIdx j = dis_j(generator);
-                AgentIdx i = dis_i(generator);
                 AgentIdx i_old = solution.agent(j);
-                if (i >= i_old)
-                    i++;
+                AgentIdx i = -1;
+                if (candidates) {
+                    auto agents = instance.candidate_agents(j);
+                    if (agents.empty())
+                        continue;
+                    std::uniform_int_distribution<AgentPos> dis_i_pos(0, agents.size() - 1);
+                    i = agents[dis_i_pos(generator)];
+                    if (i == i_old)
+                        continue;
+                } else {
+                    i = dis_i(generator);
+                    if (i >= i_old)
+                        i++;
+                }
                 Weight diff = solution.overcapacity(i_old) + solution.overcapacity(i)
                     - std::max((Weight)0, solution.weight(i_old) - instance.weight(j, i_old) - instance.capacity(i_old))
                     - std::max((Weight)0, solution.weight(i) + instance.weight(j, i) - instance.capacity(i));
@@ -209,6 +235,8 @@ Output generalizedassignmentsolver::repair(
                 AgentIdx i2 = solution.agent(j2);
                 if (i1 == i2)
                     continue;
+                if (candidates && (!instance.candidate(j1, i2) || !instance.candidate(j2, i1)))
+                    continue;
 
                 Weight diff = solution.overcapacity(i1) + solution.overcapacity(i2)
                     - std::max((Weight)0, solution.weight(i1) - instance.weight(j1, i1) + instance.weight(j2, i1) - instance.capacity(i1))
@@ -34,6 +34,15 @@ struct RepairOutput: Output
     Counter iterations = 0;
 };
 
+/**
+ * Apply to solution the shift or swap move decreasing its overcapacity with
+ * the smallest cost increase per unit of overcapacity removed, until it is
+ * feasible or no move decreases its overcapacity.
+ */
+void repair_shift_swap(
+        Solution& solution,
+        Info& info);
+
 Output repair(
         const Instance& instance,
         std::mt19937_64& generator,
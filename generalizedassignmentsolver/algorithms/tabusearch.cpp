@@ -0,0 +1,363 @@
+#include "generalizedassignmentsolver/algorithms/tabusearch.hpp"
+
+#include "generalizedassignmentsolver/algorithms/penaltylocalsearch.hpp"
+
+#include <set>
+#include <random>
+#include <algorithm>
+#include <vector>
+#include <limits>
+
+using namespace generalizedassignmentsolver;
+
+TabuSearchOutput& TabuSearchOutput::algorithm_end(Info& info)
+{
+    PUT(info, "Algorithm", "Iterations", iterations);
+    PUT(info, "Algorithm", "Restarts", restarts);
+    Output::algorithm_end(info);
+    VER(info, "Iterations: " << iterations << std::endl);
+    VER(info, "Restarts: " << restarts << std::endl);
+    return *this;
+}
+
+/**
+ * State of the tabu search.
+ *
+ * tabu_until_[j * m + i] is the last iteration during which moving item j to
+ * agent i is tabu, and frequencies_[j * m + i] the number of times item j
+ * has been moved to agent i.
+ *
+ * moves_[j] is the best admissible move of item j when it was last evaluated
+ * (moves_[j].j1 == -1 if none). After a move, only the moves involving the
+ * two modified agents are evaluated again, and the other ones are only
+ * re-valued with the current penalties and frequencies; the whole
+ * neighborhood is evaluated every neighborhood_evaluation_interval
+ * iterations.
+ */
+class TabuSearch
+{
+
+public:
+
+    TabuSearch(
+            const Solution& solution,
+            const TabuSearchOptionalParameters& parameters):
+        instance_(solution.instance()),
+        parameters_(parameters),
+        solution_(solution, parameters.initial_penalty, parameters.swap_agent_number),
+        tabu_until_(instance_.item_number() * instance_.agent_number(), -1),
+        frequencies_(instance_.item_number() * instance_.agent_number(), 0),
+        moves_(instance_.item_number())
+    {
+    }
+
+    const Solution& solution() const { return solution_.solution(); }
+
+    /**
+     * Apply the best admissible move; cost_best is the cost of the best
+     * feasible solution found, -1 if none.
+     */
+    void iteration(Counter it, Cost cost_best, std::mt19937_64& generator)
+    {
+        AgentIdx m = instance_.agent_number();
+        if (parameters_.neighborhood_evaluation_interval <= 1
+                || it % parameters_.neighborhood_evaluation_interval == 0)
+            modified_agents_.clear();
+
+        ItemIdx j_best = -1;
+        double v_best = std::numeric_limits<double>::infinity();
+        for (ItemIdx j = 0; j < instance_.item_number(); ++j) {
+            double v = (modified_agents_.empty())?
+                evaluate_moves(j, it, cost_best):
+                update_moves(j, it, cost_best);
+            if (v_best > v) {
+                v_best = v;
+                j_best = j;
+            }
+        }
+
+        if (j_best == -1) {
+            // All the moves are tabu.
+            clear_tabu_list();
+        } else {
+            PenalizedMove move = moves_[j_best];
+            AgentIdx i1 = solution().agent(move.j1);
+            std::uniform_int_distribution<Counter> d_tenure(
+                    parameters_.tabu_tenure, 2 * parameters_.tabu_tenure);
+            tabu_until_[move.j1 * m + i1] = it + d_tenure(generator);
+            frequencies_[move.j1 * m + move.i]++;
+            if (move.j2 != -1) {
+                tabu_until_[move.j2 * m + move.i] = it + d_tenure(generator);
+                frequencies_[move.j2 * m + i1]++;
+            }
+            solution_.apply(move);
+            modified_agents_ = {i1, move.i};
+        }
+
+        solution_.update_penalties(
+                solution().overcapacity() > 0,
+                parameters_.delta_inc,
+                parameters_.delta_dec);
+    }
+
+    /** Restart from solution; the tabu list is cleared. */
+    void restart(const Solution& solution)
+    {
+        for (ItemIdx j = 0; j < instance_.item_number(); ++j)
+            if (this->solution().agent(j) != solution.agent(j))
+                solution_.move(j, solution.agent(j));
+        clear_tabu_list();
+    }
+
+private:
+
+    /**
+     * Return true iff a move changing the overcapacity by doc and the cost by
+     * dc leads to a feasible solution better than the best one.
+     */
+    inline bool aspiration(Weight doc, Cost dc, Cost cost_best) const
+    {
+        return solution().overcapacity() + doc == 0
+            && (cost_best == -1 || solution().cost() + dc < cost_best);
+    }
+
+    inline double frequency_cost(ItemIdx j, AgentIdx i, Counter it) const
+    {
+        return parameters_.frequency_penalty * instance_.cost_max()
+            * frequencies_[j * instance_.agent_number() + i] / (it + 1);
+    }
+
+    /**
+     * Return the value of a move, infinity if it is tabu and does not
+     * satisfy the aspiration criterion.
+     */
+    inline double value(const PenalizedMove& move, Counter it, Cost cost_best) const
+    {
+        if (move.j1 == -1)
+            return std::numeric_limits<double>::infinity();
+        AgentIdx m = instance_.agent_number();
+        AgentIdx i1 = solution().agent(move.j1);
+        bool tabu = (tabu_until_[move.j1 * m + move.i] >= it)
+            || (move.j2 != -1 && tabu_until_[move.j2 * m + i1] >= it);
+        if (tabu && !aspiration(move.doc1 + move.doc2, move.dc, cost_best))
+            return std::numeric_limits<double>::infinity();
+        PCost d = solution_.pcost(move);
+        double v = d;
+        if (d >= 0) {
+            v += frequency_cost(move.j1, move.i, it);
+            if (move.j2 != -1)
+                v += frequency_cost(move.j2, i1, it);
+        }
+        return v;
+    }
+
+    /** Replace moves_[j] by move if it is better; return the best value. */
+    inline double update_move(const PenalizedMove& move, double v_best, Counter it, Cost cost_best)
+    {
+        double v = value(move, it, cost_best);
+        if (v_best > v) {
+            moves_[move.j1] = move;
+            return v;
+        }
+        return v_best;
+    }
+
+    /** Evaluate the moves of item j1 to agent i2. */
+    inline double evaluate_moves(ItemIdx j1, AgentIdx i2, double v_best, Counter it, Cost cost_best)
+    {
+        AgentIdx i1 = solution().agent(j1);
+        // Shift j1 to i2.
+        if (instance_.candidate(j1, i2))
+            v_best = update_move(solution_.shift(j1, i2), v_best, it, cost_best);
+        // Swap j1 with an item j2 of agent i2.
+        const std::vector<AgentIdx>& swap_agents = solution_.swap_agents(j1);
+        if (std::find(swap_agents.begin(), swap_agents.end(), i2) == swap_agents.end())
+            return v_best;
+        for (ItemIdx j2: solution_.agent_items(i2))
+            if (instance_.candidate(j2, i1))
+                v_best = update_move(solution_.swap(j1, j2), v_best, it, cost_best);
+        return v_best;
+    }
+
+    /** Compute the best admissible move of item j1 and return its value. */
+    inline double evaluate_moves(ItemIdx j1, Counter it, Cost cost_best)
+    {
+        AgentIdx i1 = solution().agent(j1);
+        moves_[j1] = PenalizedMove();
+        double v_best = std::numeric_limits<double>::infinity();
+        for (AgentIdx i2: instance_.candidate_agents(j1))
+            if (i2 != i1)
+                v_best = update_move(solution_.shift(j1, i2), v_best, it, cost_best);
+        for (AgentIdx i2: solution_.swap_agents(j1)) {
+            if (i2 == i1)
+                continue;
+            for (ItemIdx j2: solution_.agent_items(i2))
+                if (instance_.candidate(j2, i1))
+                    v_best = update_move(solution_.swap(j1, j2), v_best, it, cost_best);
+        }
+        return v_best;
+    }
+
+    /**
+     * Update the best admissible move of item j1 after a modification of the
+     * loads of modified_agents_ and return its value.
+     */
+    inline double update_moves(ItemIdx j1, Counter it, Cost cost_best)
+    {
+        AgentIdx i1 = solution().agent(j1);
+        auto modified = [this](AgentIdx i)
+        {
+            return std::find(modified_agents_.begin(), modified_agents_.end(), i)
+                != modified_agents_.end();
+        };
+        if (modified(i1) || (moves_[j1].j1 != -1 && modified(moves_[j1].i)))
+            return evaluate_moves(j1, it, cost_best);
+        // Only the moves to the modified agents changed.
+        double v_best = value(moves_[j1], it, cost_best);
+        if (v_best == std::numeric_limits<double>::infinity())
+            moves_[j1] = PenalizedMove();
+        for (AgentIdx i2: modified_agents_)
+            v_best = evaluate_moves(j1, i2, v_best, it, cost_best);
+        return v_best;
+    }
+
+    void clear_tabu_list()
+    {
+        std::fill(tabu_until_.begin(), tabu_until_.end(), -1);
+        modified_agents_.clear();
+    }
+
+    const Instance& instance_;
+    const TabuSearchOptionalParameters& parameters_;
+
+    PenalizedSolution solution_;
+    std::vector<Counter> tabu_until_;
+    std::vector<Counter> frequencies_;
+    /** moves_[j]: best admissible move of item j. */
+    std::vector<PenalizedMove> moves_;
+    /** Agents modified by the last move; empty to evaluate all the moves. */
+    std::vector<AgentIdx> modified_agents_;
+
+};
+
+/**
+ * Elite solutions of the tabu search, as the elite pool of path relinking.
+ *
+ * A feasible solution is inserted if it is not too close to an elite
+ * solution; then, if the set is full, it replaces the worst solution if it
+ * is better. If it is too close to an elite solution, it replaces this
+ * solution if it is better.
+ */
+class TabuSearchElite
+{
+
+public:
+
+    TabuSearchElite(const TabuSearchOptionalParameters& parameters):
+        parameters_(parameters) { }
+
+    bool empty() const { return solutions_.empty(); }
+
+    void add(const Solution& solution)
+    {
+        if (parameters_.elite_size <= 0 || !solution.feasible())
+            return;
+        if ((Counter)solutions_.size() == parameters_.elite_size
+                && solutions_[pos_worst_].cost() <= solution.cost())
+            return;
+
+        Counter pos_closest = -1;
+        ItemIdx d_closest = -1;
+        for (Counter pos = 0; pos < (Counter)solutions_.size(); ++pos) {
+            ItemIdx d = distance(solution, solutions_[pos]);
+            if (d_closest == -1 || d_closest > d) {
+                d_closest = d;
+                pos_closest = pos;
+            }
+        }
+
+        if (d_closest == 0)
+            return;
+        if (pos_closest != -1 && d_closest < parameters_.elite_minimum_distance) {
+            if (solutions_[pos_closest].cost() <= solution.cost())
+                return;
+            solutions_[pos_closest] = solution;
+        } else if ((Counter)solutions_.size() < parameters_.elite_size) {
+            solutions_.push_back(solution);
+        } else {
+            solutions_[pos_worst_] = solution;
+        }
+        for (Counter pos = 0; pos < (Counter)solutions_.size(); ++pos)
+            if (solutions_[pos_worst_].cost() < solutions_[pos].cost())
+                pos_worst_ = pos;
+    }
+
+    const Solution& random(std::mt19937_64& generator) const
+    {
+        std::uniform_int_distribution<Counter> d_pos(0, solutions_.size() - 1);
+        return solutions_[d_pos(generator)];
+    }
+
+private:
+
+    const TabuSearchOptionalParameters& parameters_;
+    std::vector<Solution> solutions_;
+    /** Position of the worst elite solution. */
+    Counter pos_worst_ = 0;
+
+};
+
+TabuSearchOutput generalizedassignmentsolver::tabusearch(
+        const Instance& instance,
+        std::mt19937_64& generator,
+        TabuSearchOptionalParameters parameters)
+{
+    VER(parameters.info, "*** tabusearch ***" << std::endl);
+    TabuSearchOutput output(instance, parameters.info);
+
+    // Initial solution: the given one if it is complete, otherwise each item
+    // is assigned to its cheapest agent.
+    Solution solution(instance);
+    if (parameters.initial_solution != nullptr
+            && parameters.initial_solution->full()) {
+        solution = *parameters.initial_solution;
+    } else {
+        for (ItemIdx j = 0; j < instance.item_number(); ++j)
+            solution.set(j, instance.item(j).i_cmin);
+    }
+    TabuSearch tabu_search(solution, parameters);
+
+    TabuSearchElite elite_solutions(parameters);
+    Cost cost_best = -1;
+    Counter iterations_without_improvement = 0;
+    for (output.iterations = 0; parameters.info.check_time(); ++output.iterations) {
+        if (parameters.iteration_limit != -1
+                && output.iterations >= parameters.iteration_limit)
+            break;
+
+        tabu_search.iteration(output.iterations, cost_best, generator);
+
+        const Solution& solution = tabu_search.solution();
+        elite_solutions.add(solution);
+        if (solution.feasible()
+                && (cost_best == -1 || cost_best > solution.cost())) {
+            cost_best = solution.cost();
+            iterations_without_improvement = 0;
+            std::stringstream ss;
+            ss << "it " << output.iterations;
+            output.update_solution(solution, ss, parameters.info);
+            continue;
+        }
+
+        // Intensification.
+        iterations_without_improvement++;
+        if (parameters.restart_interval > 0
+                && iterations_without_improvement % parameters.restart_interval == 0
+                && !elite_solutions.empty()) {
+            tabu_search.restart(elite_solutions.random(generator));
+            output.restarts++;
+        }
+    }
+
+    return output.algorithm_end(parameters.info);
+}
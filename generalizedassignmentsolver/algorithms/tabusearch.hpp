@@ -0,0 +1,80 @@
+#pragma once
+
+#include "generalizedassignmentsolver/solution.hpp"
+
+namespace generalizedassignmentsolver
+{
+
+struct TabuSearchOptionalParameters
+{
+    Info info = Info();
+
+    /** Maximum number of iterations; -1 for no limit. */
+    Counter iteration_limit = 100000;
+    /**
+     * After moving item j out of agent i, moving it back to agent i is tabu
+     * for a number of iterations drawn in [tabu_tenure, 2 * tabu_tenure].
+     */
+    Counter tabu_tenure = 10;
+    /**
+     * Weight of the long-term memory: the value of a non-improving move of
+     * item j to agent i is increased by
+     * frequency_penalty * cmax * (number of moves of j to i) / iteration.
+     */
+    double frequency_penalty = 0.5;
+    /**
+     * Number of elite solutions kept for intensification: the best feasible
+     * solutions visited, at least elite_minimum_distance apart.
+     */
+    Counter elite_size = 10;
+    ItemIdx elite_minimum_distance = 5;
+    /**
+     * Number of iterations without improvement of the best solution after
+     * which the search restarts from an elite solution.
+     */
+    Counter restart_interval = 2000;
+    /** Initial penalty of a unit of overcapacity. */
+    PCost initial_penalty = 1;
+    /** Penalty update parameters, see Solution::update_penalties. */
+    PCost delta_inc = 0.01;
+    PCost delta_dec = 0.01;
+    /**
+     * Number of cheapest candidate agents of an item whose items are swapped
+     * with it, see penaltylocalsearch; 0 for all of them.
+     */
+    AgentPos swap_agent_number = 8;
+    /**
+     * Number of iterations between two evaluations of the whole
+     * neighborhood; in between, only the moves involving the agents modified
+     * by the last move are evaluated again.
+     */
+    Counter neighborhood_evaluation_interval = 10;
+    const Solution* initial_solution = nullptr;
+};
+
+struct TabuSearchOutput: Output
+{
+    TabuSearchOutput(const Instance& instance, Info& info): Output(instance, info) { }
+    TabuSearchOutput& algorithm_end(Info& info);
+
+    Counter iterations = 0;
+    Counter restarts = 0;
+};
+
+/**
+ * Tabu search.
+ *
+ * At each iteration, the best admissible shift or swap move for the
+ * penalized cost is applied, even if it does not improve the solution. The
+ * capacity penalties are updated after each iteration as in
+ * penaltylocalsearch. A tabu move is admissible if it leads to a feasible
+ * solution better than the best one found (aspiration). The search restarts
+ * from a random elite solution when the best solution has not been improved
+ * for a while.
+ */
+TabuSearchOutput tabusearch(
+        const Instance& instance,
+        std::mt19937_64& generator,
+        TabuSearchOptionalParameters parameters = {});
+
+}
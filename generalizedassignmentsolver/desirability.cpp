@@ -7,6 +7,23 @@
 
 using namespace generalizedassignmentsolver;
 
+DesirabilityMatrix::DesirabilityMatrix(const Instance& instance, const Desirability& f):
+    agent_number_(instance.agent_number()),
+    values_(instance.item_number() * instance.agent_number()),
+    name_(f.to_string())
+{
+    ItemIdx n = instance.item_number();
+    AgentIdx m = agent_number_;
+    desirability_dispatch(f, [this, &instance, n, m](const auto& g)
+    {
+        for (ItemIdx j = 0; j < n; ++j) {
+            float* values_j = values_.data() + j * m;
+            for (AgentIdx i: instance.eligible_agents(j))
+                values_j[i] = g(j, i);
+        }
+    });
+}
+
 std::unique_ptr<Desirability> generalizedassignmentsolver::desirability(std::string str, const Instance& ins)
 {
     if (str == "cij") {
@@ -8,6 +8,7 @@ namespace generalizedassignmentsolver
 class Desirability
 {
 public:
+    virtual ~Desirability() { }
     virtual double operator()(ItemIdx j, AgentIdx i) const = 0;
     virtual std::string to_string() const = 0;
 };
@@ -19,7 +20,7 @@ public:
 /**
  * fij = cij
  */
-class DesirabilityCost: public Desirability
+class DesirabilityCost final: public Desirability
 {
 public:
     DesirabilityCost(const Instance& ins): instance(ins) { }
@@ -35,7 +36,7 @@ private:
 /**
  * fij = wij
  */
-class DesirabilityWeight: public Desirability
+class DesirabilityWeight final: public Desirability
 {
 public:
     DesirabilityWeight(const Instance& ins): instance(ins) { }
@@ -51,7 +52,7 @@ private:
 /**
  * fij = cij * wij
  */
-class DesirabilityCostWeight: public Desirability
+class DesirabilityCostWeight final: public Desirability
 {
 public:
     DesirabilityCostWeight(const Instance& ins): instance(ins) { }
@@ -68,7 +69,7 @@ private:
  * fij = (cij - cjmax) / wij
  * This function comes from the maximization formulation of GAP.
  */
-class DesirabilityEfficiency: public Desirability
+class DesirabilityEfficiency final: public Desirability
 {
 public:
     DesirabilityEfficiency(const Instance& ins): instance(ins) { }
@@ -84,7 +85,7 @@ private:
 /**
  * fij = wij / ti
  */
-class DesirabilityWeightCapacity: public Desirability
+class DesirabilityWeightCapacity final: public Desirability
 {
 public:
     DesirabilityWeightCapacity(const Instance& ins): instance(ins) { }
@@ -100,7 +101,7 @@ private:
 /**
  * fij = cij - vj
  */
-class DesirabilityRcost1: public Desirability
+class DesirabilityRcost1 final: public Desirability
 {
 public:
     DesirabilityRcost1(const Instance& ins, const std::vector<double>& v):
@@ -124,7 +125,7 @@ private:
 /**
  * fij = cij - ui wij
  */
-class DesirabilityRcost2: public Desirability
+class DesirabilityRcost2 final: public Desirability
 {
 public:
     DesirabilityRcost2(const Instance& instance, const std::vector<double>& u):
@@ -145,6 +146,59 @@ private:
     std::vector<double> u_;
 };
 
+/**
+ * Desirability function whose values are computed once and stored in a
+ * contiguous item-major matrix.
+ *
+ * Evaluating it is a load instead of a virtual call; algorithms sorting
+ * alternatives by desirability build one before sorting. Only the eligible
+ * alternatives are evaluated, the values of the others are 0. The values are
+ * stored as floats to halve the size of the matrix.
+ */
+class DesirabilityMatrix final: public Desirability
+{
+public:
+    DesirabilityMatrix(const Instance& instance, const Desirability& f);
+    double operator()(ItemIdx j, AgentIdx i) const
+    {
+        return values_[j * agent_number_ + i];
+    }
+    std::string to_string() const { return name_; }
+private:
+    AgentIdx agent_number_;
+    std::vector<float> values_;
+    std::string name_;
+};
+
+/**
+ * Call function with f cast to its dynamic type if it is one of the
+ * desirability functions above, so that its calls are not virtual and can
+ * be inlined, and with f itself otherwise.
+ */
+template <typename Function>
+void desirability_dispatch(const Desirability& f, Function function)
+{
+    if (auto g = dynamic_cast<const DesirabilityMatrix*>(&f)) {
+        function(*g);
+    } else if (auto g = dynamic_cast<const DesirabilityCost*>(&f)) {
+        function(*g);
+    } else if (auto g = dynamic_cast<const DesirabilityWeight*>(&f)) {
+        function(*g);
+    } else if (auto g = dynamic_cast<const DesirabilityCostWeight*>(&f)) {
+        function(*g);
+    } else if (auto g = dynamic_cast<const DesirabilityEfficiency*>(&f)) {
+        function(*g);
+    } else if (auto g = dynamic_cast<const DesirabilityWeightCapacity*>(&f)) {
+        function(*g);
+    } else if (auto g = dynamic_cast<const DesirabilityRcost1*>(&f)) {
+        function(*g);
+    } else if (auto g = dynamic_cast<const DesirabilityRcost2*>(&f)) {
+        function(*g);
+    } else {
+        function(f);
+    }
+}
+
 std::unique_ptr<Desirability> desirability(std::string str, const Instance& ins);
 
 }
@@ -34,13 +34,12 @@ Instance Generator::generate()
     AgentIdx m_eff = std::round(truncated_normal(m, (double)m / 10, 2, 2 * m - 2, g));
     ItemIdx  n_eff = std::round(truncated_normal(n, (double)n / 10, m_eff, 2 * n - m_eff, g));
 
-    Instance ins(m_eff);
+    InstanceBuilder ins(n_eff, m_eff);
 
     // Weights and profits
     Weight wsum_min = 0;
     Weight wsum_max = 0;
     for (ItemIdx j=0; j<n_eff; ++j) {
-        ins.add_item();
         Weight wj = std::round(truncated_normal(r / 2, (double)r / 10, 1, r - 1, g));
         Weight wj_min = r;
         Weight wj_max = 0;
@@ -67,6 +66,6 @@ Instance Generator::generate()
         ins.set_capacity(i, ti);
     }
 
-    return ins;
+    return ins.build();
 }
 
@@ -11,6 +11,7 @@ int main(int argc, char *argv[])
     // Parse program options
     Generator data;
     std::string output_file = "";
+    std::string output_format = "orlibrary";
     po::options_description desc("Allowed options");
     desc.add_options()
         ("help,h", "produce help message")
@@ -21,6 +22,7 @@ int main(int argc, char *argv[])
         (",x", po::value<double>(&data.x), "set x")
         (",s", po::value<Seed>(&data.s), "set seed")
         (",o", po::value<std::string>(&output_file), "set output file")
+        (",f", po::value<std::string>(&output_format), "set output file format: orlibrary, binary (default: orlibrary)")
         ;
     po::variables_map vm;
     po::store(po::parse_command_line(argc, argv, desc), vm);
@@ -39,7 +41,7 @@ int main(int argc, char *argv[])
     Instance ins = data.generate();
 
     if (output_file != "")
-        ins.write(output_file);
+        ins.write(output_file, output_format);
 
     return 0;
 }
@@ -1,36 +1,192 @@
 #include "generalizedassignmentsolver/instance.hpp"
 
 #include "generalizedassignmentsolver/solution.hpp"
+#include "generalizedassignmentsolver/desirability.hpp"
+#include "generalizedassignmentsolver/mappedfile.hpp"
+
+#include <type_traits>
+#include <stdexcept>
 
 using namespace generalizedassignmentsolver;
 
-Instance::Instance(AgentIdx m)
+IntegerArray::IntegerArray(const IntegerArray& array):
+    size_(array.size_),
+    width_(array.width_),
+    buffer_(array.buffer_),
+    data_((array.view())? array.data_: buffer_.data()),
+    owner_(array.owner_)
+{ }
+
+IntegerArray& IntegerArray::operator=(const IntegerArray& array)
+{
+    if (this != &array) {
+        IntegerArray array_tmp(array);
+        swap(array_tmp);
+    }
+    return *this;
+}
+
+void IntegerArray::resize(std::size_t size)
+{
+    if (view())
+        detach();
+    size_ = size;
+    buffer_.resize(size * width_, 0);
+    data_ = buffer_.data();
+}
+
+void IntegerArray::reserve(std::size_t size)
 {
-    t_.resize(m);
+    if (view())
+        detach();
+    buffer_.reserve(size * width_);
+    data_ = buffer_.data();
+}
+
+void IntegerArray::clear()
+{
+    size_ = 0;
+    width_ = 2;
+    buffer_.clear();
+    data_ = buffer_.data();
+    owner_ = nullptr;
+}
+
+void IntegerArray::swap(IntegerArray& array)
+{
+    std::swap(size_, array.size_);
+    std::swap(width_, array.width_);
+    buffer_.swap(array.buffer_);
+    std::swap(data_, array.data_);
+    owner_.swap(array.owner_);
+}
+
+void IntegerArray::set_width(int width)
+{
+    if (width == width_)
+        return;
+    IntegerArray array;
+    array.width_ = width;
+    array.resize(size_);
+    for (std::size_t pos = 0; pos < size_; ++pos)
+        array.set(pos, (*this)[pos]);
+    swap(array);
+}
+
+void IntegerArray::set_view(
+        const char* data,
+        std::size_t size,
+        int width,
+        std::shared_ptr<const void> owner)
+{
+    size_ = size;
+    width_ = width;
+    buffer_.clear();
+    data_ = data;
+    owner_ = owner;
+}
+
+void IntegerArray::detach()
+{
+    buffer_.assign(data_, data_ + size_ * width_);
+    data_ = buffer_.data();
+    owner_ = nullptr;
+}
+
+Instance::Instance(AgentIdx m):
+    data_(std::make_shared<Data>())
+{
+    data_->capacities.resize(m);
+    data_->item_stride = m;
+}
+
+Instance::Data& Instance::data()
+{
+    if (data_.use_count() > 1) {
+        // The eligible alternatives of the shared payload may be computed
+        // concurrently by one of its readers.
+        std::shared_ptr<Data> data_shared = data_;
+        std::lock_guard<std::mutex> lock(data_shared->eligibility.mutex);
+        data_ = std::make_shared<Data>(*data_shared);
+    }
+    return *data_;
 }
 
 void Instance::set_capacities(const std::vector<Weight>& t)
 {
+    Data& d = data();
     for (AgentIdx i = 0; i < (AgentIdx)t.size(); ++i)
-        set_capacity(i, t[i]);
+        d.capacities[i] = t[i];
+    d.candidate_agents_start.clear();
+    d.eligibility.outdated = true;
 }
 
 void Instance::clear()
 {
-    name_ = "";
-    items_.clear();
-    t_.clear();
-    c_max_ = 0;
-    c_tot_ = 0;
+    data_ = std::make_shared<Data>();
     sol_opt_ = NULL;
 }
 
 void Instance::add_item(const std::vector<std::pair<Weight, Cost>>& a)
 {
     ItemIdx j = item_number();
-    add_item();
+    Data& d = data();
+    d.items.push_back({});
+    d.items[j].j = j;
+    d.weights.resize(d.weights.size() + agent_number());
+    d.costs.resize(d.costs.size() + agent_number());
+    if (!d.removed.empty())
+        d.removed.resize(d.removed.size() + agent_number(), 0);
     for (AgentIdx i = 0; i < (AgentIdx)a.size(); ++i)
-        set_alternative(j, i, a[i].first, a[i].second);
+        set_alternative_statistics(j, i, a[i].first, a[i].second);
+    d.candidate_agents_start.clear();
+    d.eligibility.outdated = true;
+}
+
+void Instance::set_matrix_layout(MatrixLayout layout)
+{
+    if (layout == data_->layout)
+        return;
+    Data& d = data();
+    ItemIdx n = item_number();
+    AgentIdx m = agent_number();
+    IntegerArray weights;
+    IntegerArray costs;
+    std::vector<int8_t> removed(d.removed.size(), 0);
+    weights.set_width(d.weights.width());
+    costs.set_width(d.costs.width());
+    weights.resize(d.weights.size());
+    costs.resize(d.costs.size());
+    std::size_t item_stride = (layout == MatrixLayout::ItemMajor)? m: 1;
+    std::size_t agent_stride = (layout == MatrixLayout::ItemMajor)? 1: n;
+    for (ItemIdx j = 0; j < n; ++j) {
+        for (AgentIdx i = 0; i < m; ++i) {
+            weights.set(j * item_stride + i * agent_stride, weight(j, i));
+            costs.set(j * item_stride + i * agent_stride, cost(j, i));
+            if (!removed.empty())
+                removed[j * item_stride + i * agent_stride] = d.removed[position(j, i)];
+        }
+    }
+    d.weights.swap(weights);
+    d.costs.swap(costs);
+    d.removed.swap(removed);
+    d.layout = layout;
+    d.item_stride = item_stride;
+    d.agent_stride = agent_stride;
+}
+
+std::istream& generalizedassignmentsolver::operator>>(std::istream& in, MatrixLayout& layout)
+{
+    std::string token;
+    in >> token;
+    if (token == "item-major") {
+        layout = MatrixLayout::ItemMajor;
+    } else if (token == "agent-major") {
+        layout = MatrixLayout::AgentMajor;
+    } else  {
+        in.setstate(std::ios_base::failbit);
+    }
+    return in;
 }
 
 void Instance::set_optimal_solution(Solution& solution)
@@ -38,67 +194,386 @@ void Instance::set_optimal_solution(Solution& solution)
     sol_opt_ = std::make_unique<Solution>(solution);
 }
 
-Instance::Instance(std::string filepath, std::string format): name_(filepath)
+/**
+ * Scanner reading integers from a character buffer.
+ */
+class generalizedassignmentsolver::IntegerScanner
 {
-    std::ifstream file(filepath);
-    if (!file.good()) {
-        std::cerr << "\033[31m" << "ERROR, unable to open file \"" << filepath << "\"" << "\033[0m" << std::endl;
-        assert(false);
+
+public:
+
+    IntegerScanner(const char* begin, const char* end): p_(begin), end_(end) { }
+
+    /** Return false if the end of the buffer has been reached before. */
+    bool good() const { return good_; }
+
+    inline int64_t next()
+    {
+        while (p_ != end_ && (unsigned char)*p_ <= ' ')
+            ++p_;
+        bool negative = false;
+        if (p_ != end_ && (*p_ == '-' || *p_ == '+')) {
+            negative = (*p_ == '-');
+            ++p_;
+        }
+        if (p_ == end_ || *p_ < '0' || *p_ > '9') {
+            good_ = false;
+            return 0;
+        }
+        int64_t value = 0;
+        while (p_ != end_ && *p_ >= '0' && *p_ <= '9') {
+            value = 10 * value + (*p_ - '0');
+            ++p_;
+        }
+        return (negative)? -value: value;
+    }
+
+private:
+
+    const char* p_;
+    const char* end_;
+    bool good_ = true;
+
+};
+
+Instance::Instance(std::string filepath, std::string format):
+    data_(std::make_shared<Data>())
+{
+    data_->name = filepath;
+    auto file = std::make_shared<const MappedFile>(filepath);
+    if (!file->good())
+        throw std::runtime_error("Unable to open file \"" + filepath + "\".");
+
+    if (format == "binary") {
+        read_binary(file);
+        compute_eligibility();
         return;
     }
 
+    IntegerScanner scanner(file->data(), file->data() + file->size());
     if (format == "orlibrary") {
-        read_orlibrary(file);
+        read_orlibrary(scanner);
     } else if (format == "standard") {
-        read_standard(file);
+        read_standard(scanner);
     } else {
-        std::cerr << "\033[31m" << "ERROR, unknown instance format \"" << format << "\"" << "\033[0m" << std::endl;
+        throw std::invalid_argument("Unknown instance format \"" + format + "\".");
     }
 
-    file.close();
+    if (!scanner.good())
+        throw std::runtime_error("Unexpected end of file \"" + filepath + "\".");
+    compute_eligibility();
+}
+
+/**
+ * Header of the binary instance format.
+ *
+ * A binary instance file contains, in this order:
+ * - the header
+ * - the capacities (agent_number Weight)
+ * - the items (item_number Item)
+ * - the weight matrix at offset weights_offset
+ * - the cost matrix at offset costs_offset
+ * The matrices are stored with their in-memory layout and width, starting on
+ * 64-byte boundaries, so that they can be used directly from a memory-mapped
+ * file.
+ */
+struct BinaryHeader
+{
+    char magic[4];
+    uint32_t version;
+    /** BINARY_BYTE_ORDER written with the byte order of the writer. */
+    uint32_t byte_order;
+    int32_t layout;
+    int32_t weight_width;
+    int32_t cost_width;
+    int64_t agent_number;
+    int64_t item_number;
+    int64_t c_max;
+    int64_t c_tot;
+    int64_t w_max;
+    int64_t c_min_sum;
+    uint64_t weights_offset;
+    uint64_t costs_offset;
+};
+
+static const char BINARY_MAGIC[4] = {'G', 'A', 'P', 'B'};
+static const uint32_t BINARY_VERSION = 1;
+static const uint32_t BINARY_BYTE_ORDER = 0x01020304;
+
+static_assert(std::is_trivially_copyable<Item>::value, "Item must be trivially copyable.");
+
+inline uint64_t binary_align(uint64_t offset)
+{
+    return (offset + 63) / 64 * 64;
+}
+
+void Instance::read_binary(const std::shared_ptr<const MappedFile>& file)
+{
+    Data& d = data();
+    auto error = [&d](std::string message)
+    {
+        throw std::runtime_error(
+                "Invalid binary instance file \"" + d.name + "\": " + message + ".");
+    };
+
+    BinaryHeader header;
+    std::size_t size = file->size();
+    if (size < sizeof(header))
+        error("unexpected end of file");
+    std::memcpy(&header, file->data(), sizeof(header));
+    if (std::memcmp(header.magic, BINARY_MAGIC, 4) != 0)
+        error("wrong magic number");
+    if (header.version != BINARY_VERSION)
+        error("unsupported version");
+    if (header.byte_order != BINARY_BYTE_ORDER)
+        error("wrong byte order");
+    if (header.layout != (int32_t)MatrixLayout::ItemMajor
+            && header.layout != (int32_t)MatrixLayout::AgentMajor)
+        error("unknown matrix layout");
+    for (int32_t width: {header.weight_width, header.cost_width})
+        if (width != 2 && width != 4 && width != 8)
+            error("unsupported matrix width");
+
+    // Return true iff 'number' values of 'width' bytes starting at 'offset'
+    // are inside the file; the products are checked for overflow.
+    auto fits = [size](uint64_t offset, uint64_t number, uint64_t width)
+    {
+        return offset <= size && number <= (size - offset) / width;
+    };
+    if (header.agent_number < 0 || header.item_number < 0)
+        error("negative size");
+    std::size_t m = header.agent_number;
+    std::size_t n = header.item_number;
+    if (!fits(sizeof(header), m, sizeof(Weight)))
+        error("unexpected end of file");
+    std::size_t items_offset = sizeof(header) + m * sizeof(Weight);
+    if (!fits(items_offset, n, sizeof(Item)))
+        error("unexpected end of file");
+    std::size_t items_end = items_offset + n * sizeof(Item);
+    if (m != 0 && n > SIZE_MAX / m)
+        error("too many alternatives");
+    std::size_t alternative_number = n * m;
+    if (header.weights_offset < items_end
+            || !fits(header.weights_offset, alternative_number, header.weight_width)
+            || header.costs_offset < header.weights_offset + alternative_number * header.weight_width
+            || !fits(header.costs_offset, alternative_number, header.cost_width))
+        error("unexpected end of file");
+
+    // Capacities and items are copied.
+    d.capacities.resize(m);
+    std::memcpy(d.capacities.data(), file->data() + sizeof(header), m * sizeof(Weight));
+    d.items.resize(n);
+    std::memcpy(d.items.data(), file->data() + items_offset, n * sizeof(Item));
+
+    // Matrices are used in place.
+    d.weights.set_view(file->data() + header.weights_offset, alternative_number, header.weight_width, file);
+    d.costs.set_view(file->data() + header.costs_offset, alternative_number, header.cost_width, file);
+    d.layout = (MatrixLayout)header.layout;
+    d.item_stride = (d.layout == MatrixLayout::ItemMajor)? m: 1;
+    d.agent_stride = (d.layout == MatrixLayout::ItemMajor)? 1: n;
+
+    d.c_max = header.c_max;
+    d.c_tot = header.c_tot;
+    d.w_max = header.w_max;
+    d.c_min_sum = header.c_min_sum;
 }
 
-void Instance::read_orlibrary(std::ifstream& file)
+void Instance::write_binary(std::string filepath)
 {
-    ItemIdx n;
-    AgentIdx m;
-    file >> m >> n;
+    const Data& d = *data_;
+    std::size_t n = item_number();
+    std::size_t m = agent_number();
 
-    t_.resize(m);
-    items_.reserve(n);
-    for (ItemPos j = 0; j < n; ++j)
-        add_item();
+    BinaryHeader header;
+    std::memcpy(header.magic, BINARY_MAGIC, 4);
+    header.version = BINARY_VERSION;
+    header.byte_order = BINARY_BYTE_ORDER;
+    header.layout = (int32_t)d.layout;
+    header.weight_width = d.weights.width();
+    header.cost_width = d.costs.width();
+    header.agent_number = m;
+    header.item_number = n;
+    header.c_max = d.c_max;
+    header.c_tot = d.c_tot;
+    header.w_max = d.w_max;
+    header.c_min_sum = d.c_min_sum;
+    header.weights_offset = binary_align(sizeof(header) + m * sizeof(Weight) + n * sizeof(Item));
+    header.costs_offset = binary_align(header.weights_offset + n * m * d.weights.width());
+
+    std::ofstream file(filepath, std::ios::binary);
+    if (!file.good()) {
+        std::cerr << "\033[31m" << "ERROR, unable to open file \"" << filepath << "\"" << "\033[0m" << std::endl;
+        return;
+    }
+    auto pad = [&file](uint64_t offset)
+    {
+        while ((uint64_t)file.tellp() < offset)
+            file.put(0);
+    };
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(d.capacities.data()), m * sizeof(Weight));
+    file.write(reinterpret_cast<const char*>(d.items.data()), n * sizeof(Item));
+    pad(header.weights_offset);
+    file.write(d.weights.data(), n * m * d.weights.width());
+    pad(header.costs_offset);
+    file.write(d.costs.data(), n * m * d.costs.width());
+}
+
+void Instance::allocate(ItemIdx n, AgentIdx m)
+{
+    Data& d = data();
+    d.capacities.resize(m);
+    d.items.resize(n);
+    for (ItemIdx j = 0; j < n; ++j)
+        d.items[j].j = j;
+    d.weights.resize(n * m);
+    d.costs.resize(n * m);
+    d.item_stride = m;
+}
+
+void Instance::compute_statistics()
+{
+    Data& d = data();
+    d.c_max = -1;
+    d.c_tot = 0;
+    d.w_max = -1;
+    d.c_min_sum = 0;
+    for (ItemIdx j = 0; j < item_number(); ++j) {
+        Item& item = d.items[j];
+        item = Item();
+        item.j = j;
+        for (AgentIdx i = 0; i < agent_number(); ++i) {
+            Weight w = weight(j, i);
+            Cost c = cost(j, i);
+            item.w += w;
+            item.c += c;
+            if (item.i_cmin == -1 || item.c_min > c) {
+                item.i_cmin = i;
+                item.c_min = c;
+            }
+            if (item.i_wmin == -1 || item.w_min > w) {
+                item.i_wmin = i;
+                item.w_min = w;
+            }
+            if (item.c_max < c) {
+                item.i_cmax = i;
+                item.c_max = c;
+            }
+            if (item.w_max < w) {
+                item.i_wmax = i;
+                item.w_max = w;
+            }
+        }
+        if (item.i_cmin != -1)
+            d.c_min_sum += item.c_min;
+        if (d.c_max < item.c_max)
+            d.c_max = item.c_max;
+        if (d.w_max < item.w_max)
+            d.w_max = item.w_max;
+        d.c_tot += item.c;
+    }
+}
+
+void Instance::compute_eligibility() const
+{
+    Data& d = *data_;
+    std::lock_guard<std::mutex> lock(d.eligibility.mutex);
+    if (!d.eligibility.outdated)
+        return;
+    ItemIdx n = item_number();
+    AgentIdx m = agent_number();
+
+    d.eligible_agents_start.assign(n + 1, 0);
+    d.eligible_items_start.assign(m + 1, 0);
+    for (ItemIdx j = 0; j < n; ++j) {
+        d.eligible_agents_start[j + 1] = d.eligible_agents_start[j];
+        for (AgentIdx i = 0; i < m; ++i) {
+            if (eligible(j, i)) {
+                d.eligible_agents_start[j + 1]++;
+                d.eligible_items_start[i + 1]++;
+            }
+        }
+    }
     for (AgentIdx i = 0; i < m; ++i)
-        for (ItemPos j = 0; j < n; ++j)
-            file >> items_[j].alternatives[i].c;
+        d.eligible_items_start[i + 1] += d.eligible_items_start[i];
+
+    d.eligible_agents.resize(d.eligible_agents_start[n]);
+    d.eligible_items.resize(d.eligible_items_start[m]);
+    std::vector<std::size_t> pos(d.eligible_items_start.begin(), d.eligible_items_start.end() - 1);
+    for (ItemIdx j = 0; j < n; ++j) {
+        std::size_t k = d.eligible_agents_start[j];
+        for (AgentIdx i = 0; i < m; ++i) {
+            if (eligible(j, i)) {
+                d.eligible_agents[k++] = i;
+                d.eligible_items[pos[i]++] = j;
+            }
+        }
+    }
+    d.eligibility.outdated = false;
+}
+
+void Instance::set_candidate_agents(const Desirability& f, AgentPos k)
+{
+    ItemIdx n = item_number();
+    std::vector<std::size_t> candidate_agents_start(n + 1, 0);
+    std::vector<AgentIdx> candidate_agents;
+    std::vector<std::pair<double, AgentIdx>> agents;
+    for (ItemIdx j = 0; j < n; ++j) {
+        agents.clear();
+        for (AgentIdx i: eligible_agents(j))
+            agents.push_back({f(j, i), i});
+        AgentPos k_j = std::min(k, (AgentPos)agents.size());
+        std::partial_sort(agents.begin(), agents.begin() + k_j, agents.end());
+        std::sort(agents.begin(), agents.begin() + k_j,
+                [](const std::pair<double, AgentIdx>& a1, const std::pair<double, AgentIdx>& a2) -> bool
+                {
+                    return a1.second < a2.second;
+                });
+        for (AgentPos i_pos = 0; i_pos < k_j; ++i_pos)
+            candidate_agents.push_back(agents[i_pos].second);
+        candidate_agents_start[j + 1] = candidate_agents.size();
+    }
+
+    Data& d = data();
+    d.candidate_agent_number = k;
+    d.candidate_agents_start.swap(candidate_agents_start);
+    d.candidate_agents.swap(candidate_agents);
+}
+
+void Instance::read_orlibrary(IntegerScanner& scanner)
+{
+    AgentIdx m = scanner.next();
+    ItemIdx n = scanner.next();
+    allocate(n, m);
+    Data& d = data();
+
+    // The costs are stored first, so the statistics of each alternative are
+    // updated while reading its weight.
     for (AgentIdx i = 0; i < m; ++i)
         for (ItemPos j = 0; j < n; ++j)
-            file >> items_[j].alternatives[i].w;
+            d.costs.set(position(j, i), scanner.next());
     for (AgentIdx i = 0; i < m; ++i)
         for (ItemPos j = 0; j < n; ++j)
-            set_alternative(j, i, items_[j].alternatives[i].w, items_[j].alternatives[i].c);
+            set_alternative_statistics(j, i, scanner.next(), cost(j, i));
     for (AgentIdx i = 0; i < m; ++i)
-        file >> t_[i];
+        d.capacities[i] = scanner.next();
 }
 
-void Instance::read_standard(std::ifstream& file)
+void Instance::read_standard(IntegerScanner& scanner)
 {
-    ItemIdx  n;
-    AgentIdx m;
-    file >> m >> n;
+    AgentIdx m = scanner.next();
+    ItemIdx n = scanner.next();
+    allocate(n, m);
+    Data& d = data();
 
-    t_.resize(m);
     for (AgentIdx i = 0; i < m; ++i)
-        file >> t_[i];
+        d.capacities[i] = scanner.next();
 
-    items_.reserve(n);
-    Weight w;
-    Cost c;
     for (ItemPos j = 0; j < n; ++j) {
-        add_item();
         for (AgentIdx i = 0; i < m; ++i) {
-            file >> w >> c;
-            set_alternative(j, i, w, c);
+            Weight w = scanner.next();
+            Cost c = scanner.next();
+            set_alternative_statistics(j, i, w, c);
         }
     }
 }
@@ -106,11 +581,7 @@ void Instance::read_standard(std::ifstream& file)
 Instance::~Instance() {  }
 
 Instance::Instance(const Instance& instance):
-    name_(instance.name_),
-    items_(instance.items_),
-    t_(instance.t_),
-    c_max_(instance.c_max_),
-    c_tot_(instance.c_tot_)
+    data_(instance.data_)
 {
     if (instance.optimal_solution() != NULL) {
         sol_opt_ = std::make_unique<Solution>(*this);
@@ -118,23 +589,92 @@ Instance::Instance(const Instance& instance):
     }
 }
 
+Instance::Instance(Instance&& instance):
+    data_(std::move(instance.data_))
+{
+    instance.data_ = std::make_shared<Data>();
+    if (instance.optimal_solution() != NULL) {
+        sol_opt_ = std::make_unique<Solution>(*this);
+        *sol_opt_ = *instance.optimal_solution();
+        instance.sol_opt_ = NULL;
+    }
+}
+
 Instance& Instance::operator=(const Instance& instance)
 {
     if (this != &instance) {
-        name_         = instance.name_;
-        items_        = instance.items_;
-        t_            = instance.t_;
-        c_max_        = instance.c_max_;
-        c_tot_        = instance.c_tot_;
+        data_ = instance.data_;
+        sol_opt_ = NULL;
+        if (instance.optimal_solution() != NULL) {
+            sol_opt_ = std::make_unique<Solution>(*this);
+            *sol_opt_ = *instance.optimal_solution();
+        }
+    }
+    return *this;
+}
 
+Instance& Instance::operator=(Instance&& instance)
+{
+    if (this != &instance) {
+        data_ = std::move(instance.data_);
+        instance.data_ = std::make_shared<Data>();
+        sol_opt_ = NULL;
         if (instance.optimal_solution() != NULL) {
             sol_opt_ = std::make_unique<Solution>(*this);
             *sol_opt_ = *instance.optimal_solution();
+            instance.sol_opt_ = NULL;
         }
     }
     return *this;
 }
 
+InstanceBuilder::InstanceBuilder(ItemIdx n, AgentIdx m, MatrixLayout layout):
+    instance_(m)
+{
+    Instance::Data& d = *instance_.data_;
+    d.items.resize(n);
+    for (ItemIdx j = 0; j < n; ++j)
+        d.items[j].j = j;
+    d.weights.resize(n * m);
+    d.costs.resize(n * m);
+    d.layout = layout;
+    d.item_stride = (layout == MatrixLayout::ItemMajor)? m: 1;
+    d.agent_stride = (layout == MatrixLayout::ItemMajor)? 1: n;
+}
+
+void InstanceBuilder::set_capacities(const Weight* t)
+{
+    for (AgentIdx i = 0; i < instance_.agent_number(); ++i)
+        set_capacity(i, t[i]);
+}
+
+void InstanceBuilder::remove_alternative(ItemIdx j, AgentIdx i)
+{
+    std::vector<int8_t>& removed = instance_.data_->removed;
+    if (removed.empty())
+        removed.resize(instance_.item_number() * instance_.agent_number(), 0);
+    removed[instance_.position(j, i)] = 1;
+}
+
+void InstanceBuilder::set_item(ItemIdx j, const Weight* weights, const Cost* costs)
+{
+    for (AgentIdx i = 0; i < instance_.agent_number(); ++i)
+        set_alternative(j, i, weights[i], costs[i]);
+}
+
+void InstanceBuilder::set_agent(AgentIdx i, const Weight* weights, const Cost* costs)
+{
+    for (ItemIdx j = 0; j < instance_.item_number(); ++j)
+        set_alternative(j, i, weights[j], costs[j]);
+}
+
+Instance InstanceBuilder::build()
+{
+    instance_.compute_statistics();
+    instance_.compute_eligibility();
+    return std::move(instance_);
+}
+
 Cost Instance::optimum() const
 {
     return optimal_solution()->cost();
@@ -165,18 +705,29 @@ std::ostream& generalizedassignmentsolver::operator<<(std::ostream& os, const In
     return os;
 }
 
-void Instance::write(std::string filename)
+void Instance::write(std::string filepath, std::string format)
+{
+    if (format == "orlibrary") {
+        write_orlibrary(filepath);
+    } else if (format == "binary") {
+        write_binary(filepath);
+    } else {
+        std::cerr << "\033[31m" << "ERROR, unknown instance format \"" << format << "\"" << "\033[0m" << std::endl;
+    }
+}
+
+void Instance::write_orlibrary(std::string filename)
 {
     std::ofstream file(filename);
     file << agent_number() << " " << item_number() << std::endl;
     for (AgentIdx i = 0; i < agent_number(); ++i) {
         for (ItemIdx j = 0; j < item_number(); ++j)
-            file << item(j).alternatives[i].c << " ";
+            file << cost(j, i) << " ";
         file << std::endl;
     }
     for (AgentIdx i = 0; i < agent_number(); ++i) {
         for (ItemIdx j = 0; j < item_number(); ++j)
-            file << item(j).alternatives[i].w << " ";
+            file << weight(j, i) << " ";
         file << std::endl;
     }
     for (AgentIdx i = 0; i < agent_number(); ++i)
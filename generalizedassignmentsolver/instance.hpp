@@ -9,7 +9,12 @@
 #include <iostream>
 #include <chrono>
 #include <memory>
+#include <atomic>
+#include <mutex>
 #include <map>
+#include <vector>
+#include <cstring>
+#include <type_traits>
 
 namespace generalizedassignmentsolver
 {
@@ -28,6 +33,162 @@ typedef int64_t Counter;
 typedef int64_t Seed;
 
 class Solution;
+class IntegerScanner;
+class MappedFile;
+class InstanceBuilder;
+class Desirability;
+
+/**
+ * Allocator returning blocks aligned on cache lines.
+ *
+ * It is used for the weight and cost matrices so that a row always starts on
+ * a cache line boundary.
+ */
+template <typename T, std::size_t Alignment = 64>
+struct AlignedAllocator
+{
+    typedef T value_type;
+
+    template <typename U>
+    struct rebind { typedef AlignedAllocator<U, Alignment> other; };
+
+    AlignedAllocator() noexcept { }
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept { }
+
+    T* allocate(std::size_t size)
+    {
+        // Over-allocate and store the address of the raw block right before
+        // the aligned one.
+        char* raw = static_cast<char*>(::operator new(
+                    size * sizeof(T) + Alignment + sizeof(void*)));
+        std::uintptr_t address = reinterpret_cast<std::uintptr_t>(raw + sizeof(void*));
+        address = (address + Alignment - 1) & ~(std::uintptr_t)(Alignment - 1);
+        void** aligned = reinterpret_cast<void**>(address);
+        aligned[-1] = raw;
+        return reinterpret_cast<T*>(aligned);
+    }
+
+    void deallocate(T* p, std::size_t) noexcept
+    {
+        ::operator delete(reinterpret_cast<void**>(p)[-1]);
+    }
+};
+
+template <typename T, typename U, std::size_t A>
+bool operator==(const AlignedAllocator<T, A>&, const AlignedAllocator<U, A>&) { return true; }
+template <typename T, typename U, std::size_t A>
+bool operator!=(const AlignedAllocator<T, A>&, const AlignedAllocator<U, A>&) { return false; }
+
+template <typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+/**
+ * Contiguous array of integers whose storage width is chosen at runtime.
+ *
+ * Values are read and written as int64_t but stored on 2, 4 or 8 bytes. The
+ * array starts with the narrowest width and is widened automatically the
+ * first time a value which does not fit is written.
+ *
+ * An array may also be a read-only view of external memory (for example, a
+ * memory-mapped file). The memory is then kept alive by a shared owner and is
+ * copied the first time the array is modified.
+ */
+class IntegerArray
+{
+
+public:
+
+    IntegerArray() { }
+    IntegerArray(const IntegerArray& array);
+    IntegerArray& operator=(const IntegerArray& array);
+
+    inline std::size_t size() const { return size_; }
+    /** Storage width in bytes: 2, 4 or 8. */
+    inline int width() const { return width_; }
+    inline const char* data() const { return data_; }
+    /** Return true iff the array is a view of external memory. */
+    inline bool view() const { return owner_ != nullptr; }
+
+    inline int64_t operator[](std::size_t pos) const
+    {
+        const char* p = data_ + pos * width_;
+        switch (width_) {
+        case 2: { int16_t v; std::memcpy(&v, p, 2); return v; }
+        case 4: { int32_t v; std::memcpy(&v, p, 4); return v; }
+        default: { int64_t v; std::memcpy(&v, p, 8); return v; }
+        }
+    }
+
+    inline void set(std::size_t pos, int64_t value)
+    {
+        if (required_width(value) > width_)
+            set_width(required_width(value));
+        if (view())
+            detach();
+        char* p = buffer_.data() + pos * width_;
+        switch (width_) {
+        case 2: { int16_t v = (int16_t)value; std::memcpy(p, &v, 2); break; }
+        case 4: { int32_t v = (int32_t)value; std::memcpy(p, &v, 4); break; }
+        default: { std::memcpy(p, &value, 8); break; }
+        }
+    }
+
+    /** Resize the array; new values are set to 0. */
+    void resize(std::size_t size);
+    void reserve(std::size_t size);
+    void clear();
+    void swap(IntegerArray& array);
+
+    /** Change the storage width, converting the stored values. */
+    void set_width(int width);
+
+    /**
+     * Make the array a view of 'size' values of width 'width' stored at
+     * 'data'. 'owner' must keep this memory alive.
+     */
+    void set_view(
+            const char* data,
+            std::size_t size,
+            int width,
+            std::shared_ptr<const void> owner);
+
+    /** Return the smallest width able to store value. */
+    static inline int required_width(int64_t value)
+    {
+        if (value >= INT16_MIN && value <= INT16_MAX)
+            return 2;
+        if (value >= INT32_MIN && value <= INT32_MAX)
+            return 4;
+        return 8;
+    }
+
+private:
+
+    /** Copy the viewed memory into buffer_. */
+    void detach();
+
+    std::size_t size_ = 0;
+    int width_ = 2;
+    AlignedVector<char> buffer_;
+    /** Either buffer_.data() or the viewed memory. */
+    const char* data_ = nullptr;
+    std::shared_ptr<const void> owner_ = nullptr;
+
+};
+
+/**
+ * Storage order of the weight and cost matrices.
+ *
+ * - ItemMajor: the alternatives of an item are contiguous. This is the
+ *   best choice for algorithms looping over the agents of an item (greedy,
+ *   local search, Lagrangian relaxation of the knapsack constraints...).
+ * - AgentMajor: the alternatives of an agent are contiguous. This is the best
+ *   choice for algorithms building one knapsack per agent (Lagrangian
+ *   relaxation of the assignment constraints, column generation...).
+ */
+enum class MatrixLayout { ItemMajor, AgentMajor };
+std::istream& operator>>(std::istream& in, MatrixLayout& layout);
 
 struct Alternative
 {
@@ -39,13 +200,26 @@ struct Alternative
     double efficiency() const { return c * w; }
 };
 
+/** Contiguous range of indices, e.g. the eligible agents of an item. */
+template <typename T>
+struct IndexRange
+{
+    const T* first;
+    const T* last;
+
+    const T* begin() const { return first; }
+    const T* end() const { return last; }
+    std::size_t size() const { return last - first; }
+    bool empty() const { return first == last; }
+    T operator[](std::size_t pos) const { return first[pos]; }
+};
+
 struct Item
 {
     ItemIdx j;
-    std::vector<Alternative> alternatives;
 
-    Weight w; // total weight
-    Cost c; // total cost
+    Weight w = 0; // total weight
+    Cost c = 0; // total cost
 
     Cost c_min = -1; // minimum cost
     Cost c_max = -1; // maximum cost
@@ -67,26 +241,57 @@ public:
      * Constructors and destructor
      */
 
-    /** Create instance from file. */
+    /**
+     * Create instance from file.
+     *
+     * Available formats: "orlibrary", "standard" and "binary". With the
+     * "binary" format, the weight and cost matrices are used directly from
+     * the memory-mapped file.
+     *
+     * Throws std::runtime_error if the file cannot be opened or is invalid.
+     */
     Instance(std::string filename, std::string format = "orlibrary");
 
     /** Manual constructor. */
     Instance(AgentIdx m);
-    void set_name(std::string name) { name_ = name; }
-    void set_capacity(AgentIdx i, Weight t) { t_[i] = t; }
+    void set_name(std::string name) { data().name = name; }
+    void set_capacity(AgentIdx i, Weight t)
+    {
+        Data& d = data();
+        d.capacities[i] = t;
+        d.candidate_agents_start.clear();
+        d.eligibility.outdated = true;
+    }
     inline void add_item();
     inline void set_alternative(ItemIdx j, AgentIdx i, Weight w, Cost p);
     void clear();
 
+    /**
+     * Change the storage order of the weight and cost matrices.
+     *
+     * Items can only be added while the matrices are stored item-major.
+     */
+    void set_matrix_layout(MatrixLayout layout);
+
     /** Constructor for test instances. */
     void add_item(const std::vector<std::pair<Weight, Cost>>& a);
     void set_capacities(const std::vector<Weight>& t);
     void set_optimal_solution(Solution& solution);
 
-    /** Copy constructor. */
+    /**
+     * Copy constructor.
+     *
+     * The payload of an instance is shared between its copies, so copying an
+     * instance is cheap (except for its optimal solution, if any). It is
+     * copied on the first modification of one of the copies.
+     */
     Instance(const Instance& instance);
+    /** Move constructor. */
+    Instance(Instance&& instance);
     /** Copy assignment operator. */
     Instance& operator=(const Instance& instance);
+    /** Move assignment operator. */
+    Instance& operator=(Instance&& instance);
     /** Destructor. */
     ~Instance();
 
@@ -94,88 +299,341 @@ public:
      * Getters
      */
 
-    std::string name() const { return name_; }
-    const Item& item(ItemPos j) const { return items_[j]; }
+    std::string name() const { return data_->name; }
+    const Item& item(ItemPos j) const { return data_->items[j]; }
 
-    inline Cost cost_max()   const { return c_max_; }
-    inline Cost weight_max() const { return w_max_; }
+    inline Cost cost_max()   const { return data_->c_max; }
+    inline Cost weight_max() const { return data_->w_max; }
 
-    ItemIdx item_number()       const { return items_.size(); }
-    AgentIdx agent_number()     const { return t_.size(); }
-    Weight capacity(AgentIdx i) const { return t_[i]; }
+    ItemIdx item_number()       const { return data_->items.size(); }
+    AgentIdx agent_number()     const { return data_->capacities.size(); }
+    Weight capacity(AgentIdx i) const { return data_->capacities[i]; }
 
-    inline Weight weight(ItemIdx j, AgentIdx i) const { return items_[j].alternatives[i].w; }
-    inline Cost cost(ItemIdx j, AgentIdx i) const { return items_[j].alternatives[i].c; }
-    inline Cost profit(ItemIdx j, AgentIdx i) const { return items_[j].c_max - items_[j].alternatives[i].c; }
+    MatrixLayout matrix_layout() const { return data_->layout; }
+    /** Storage width in bytes of the weight and cost matrices. */
+    int weight_width() const { return data_->weights.width(); }
+    int cost_width() const { return data_->costs.width(); }
+
+    inline Weight weight(ItemIdx j, AgentIdx i) const { return data_->weights[position(j, i)]; }
+    inline Cost cost(ItemIdx j, AgentIdx i) const { return data_->costs[position(j, i)]; }
+    inline Cost profit(ItemIdx j, AgentIdx i) const { return data_->items[j].c_max - cost(j, i); }
+    inline Alternative alternative(ItemIdx j, AgentIdx i) const { return {j, i, weight(j, i), cost(j, i)}; }
+
+    /**
+     * Eligible alternatives.
+     *
+     * Alternative (j, i) is eligible if wij <= ti and if it has not been
+     * removed (see InstanceBuilder::remove_alternative); otherwise the
+     * alternative is forbidden. The eligible agents of
+     * each item and the eligible items of each agent are stored in compressed
+     * sparse row form, in increasing order of index.
+     *
+     * They are computed when an instance is read or built. The modifiers of
+     * the instance only mark them as outdated, and they are recomputed once,
+     * by the next call to eligible_agents() or eligible_items(). This
+     * computation is protected by a mutex, so that the accessors below can
+     * be called concurrently.
+     */
+    inline bool eligible(ItemIdx j, AgentIdx i) const
+    {
+        return weight(j, i) <= capacity(i)
+            && (data_->removed.empty() || !data_->removed[position(j, i)]);
+    }
+    inline IndexRange<AgentIdx> eligible_agents(ItemIdx j) const
+    {
+        if (data_->eligibility.outdated)
+            compute_eligibility();
+        const AgentIdx* agents = data_->eligible_agents.data();
+        return {agents + data_->eligible_agents_start[j], agents + data_->eligible_agents_start[j + 1]};
+    }
+    inline IndexRange<ItemIdx> eligible_items(AgentIdx i) const
+    {
+        if (data_->eligibility.outdated)
+            compute_eligibility();
+        const ItemIdx* items = data_->eligible_items.data();
+        return {items + data_->eligible_items_start[i], items + data_->eligible_items_start[i + 1]};
+    }
+
+    /**
+     * Candidate agents.
+     *
+     * The candidate agents of an item are its k most desirable eligible
+     * agents (lowest f(j, i)), stored in increasing order of index. The
+     * neighborhood scans of localsearch, nshift, repair and random only
+     * consider moves of items to their candidate agents.
+     *
+     * By default, no candidate lists are set and the candidate agents of an
+     * item are all its eligible agents. The candidate lists are removed when
+     * the instance is modified.
+     */
+    void set_candidate_agents(const Desirability& f, AgentPos k);
+    /** Return k, or 0 if no candidate lists are set. */
+    AgentPos candidate_agent_number() const
+    {
+        return (data_->candidate_agents_start.empty())? 0: data_->candidate_agent_number;
+    }
+    inline IndexRange<AgentIdx> candidate_agents(ItemIdx j) const
+    {
+        if (data_->candidate_agents_start.empty())
+            return eligible_agents(j);
+        const AgentIdx* agents = data_->candidate_agents.data();
+        return {agents + data_->candidate_agents_start[j], agents + data_->candidate_agents_start[j + 1]};
+    }
+    inline bool candidate(ItemIdx j, AgentIdx i) const
+    {
+        if (data_->candidate_agents_start.empty())
+            return eligible(j, i);
+        auto agents = candidate_agents(j);
+        return std::binary_search(agents.begin(), agents.end(), i);
+    }
 
     const Solution* optimal_solution() const { return sol_opt_.get(); }
     Cost optimum() const;
-    Cost bound() const { return c_tot_ + 1; }
-    Cost combinatorial_relaxation() const { return c_min_sum_; }
+    Cost bound() const { return data_->c_tot + 1; }
+    Cost combinatorial_relaxation() const { return data_->c_min_sum; }
 
-    void write(std::string filename);
+    /**
+     * Write instance to file; available formats: "orlibrary", "binary".
+     *
+     * Removed alternatives are written as the other ones.
+     */
+    void write(std::string filename, std::string format = "orlibrary");
 
 private:
 
-    void read_orlibrary(std::ifstream& file);
-    void read_standard(std::ifstream& file);
+    void read_orlibrary(IntegerScanner& scanner);
+    void read_standard(IntegerScanner& scanner);
+    void read_binary(const std::shared_ptr<const MappedFile>& file);
+    void write_orlibrary(std::string filename);
+    void write_binary(std::string filename);
+
+    /** Allocate the matrices of an instance with n items and m agents. */
+    void allocate(ItemIdx n, AgentIdx m);
+
+    /** Compute the item statistics from the weight and cost matrices. */
+    void compute_statistics();
+    /** Compute the eligible alternatives if they are outdated. */
+    void compute_eligibility() const;
+    /**
+     * Set alternative (j, i) and update the statistics of item j, but not the
+     * eligible alternatives.
+     */
+    inline void set_alternative_statistics(ItemIdx j, AgentIdx i, Weight w, Cost c);
 
-    std::string name_;
-    std::vector<Item> items_;
-    std::vector<Weight> t_;
-    Cost c_max_ = -1;
-    Cost c_tot_ = 0;
-    Cost w_max_ = -1;
-    Cost c_min_sum_ = 0;
+    friend class InstanceBuilder;
 
+    /** Position of alternative (j, i) in the weight and cost matrices. */
+    inline std::size_t position(ItemIdx j, AgentIdx i) const { return j * data_->item_stride + i * data_->agent_stride; }
+
+    /**
+     * Whether the eligible alternatives of a payload are outdated, and the
+     * mutex serializing their computation. Copying it only copies the flag.
+     */
+    struct EligibilityState
+    {
+        EligibilityState() { }
+        EligibilityState(const EligibilityState& state): outdated(state.outdated.load()) { }
+        EligibilityState& operator=(const EligibilityState& state)
+        {
+            outdated = state.outdated.load();
+            return *this;
+        }
+
+        std::atomic<bool> outdated {true};
+        std::mutex mutex;
+    };
+
+    /** Instance payload. */
+    struct Data
+    {
+        std::string name;
+        std::vector<Item> items;
+        std::vector<Weight> capacities;
+
+        /**
+         * Weight and cost matrices, stored contiguously according to layout.
+         * Alternative (j, i) is at position j * item_stride + i * agent_stride.
+         * Their storage width is the narrowest one which fits all the values.
+         */
+        MatrixLayout layout = MatrixLayout::ItemMajor;
+        IntegerArray weights;
+        IntegerArray costs;
+        std::size_t item_stride = 0;
+        std::size_t agent_stride = 1;
+        /**
+         * removed[pos] = 1 iff the alternative at position pos of the matrices
+         * has been removed; empty if no alternative has been removed.
+         */
+        std::vector<int8_t> removed;
+
+        Cost c_max = -1;
+        Cost c_tot = 0;
+        Weight w_max = -1;
+        Cost c_min_sum = 0;
+
+        /** Eligible alternatives, see eligible_agents() and eligible_items(). */
+        EligibilityState eligibility;
+        std::vector<std::size_t> eligible_agents_start;
+        std::vector<AgentIdx> eligible_agents;
+        std::vector<std::size_t> eligible_items_start;
+        std::vector<ItemIdx> eligible_items;
+
+        /** Candidate agents, see candidate_agents(); empty if not set. */
+        AgentPos candidate_agent_number = 0;
+        std::vector<std::size_t> candidate_agents_start;
+        std::vector<AgentIdx> candidate_agents;
+    };
+
+    /**
+     * Return the payload for modification, after copying it if it is shared
+     * with other instances.
+     */
+    Data& data();
+
+    /** Payload, shared between the copies of the instance. */
+    std::shared_ptr<Data> data_;
     std::unique_ptr<Solution> sol_opt_;
 
 };
 
 void Instance::add_item()
 {
-    ItemIdx j = items_.size();
-    items_.push_back({});
-    items_[j].j = j;
-    items_[j].alternatives.resize(agent_number());
-    for (AgentIdx i = 0; i < agent_number(); ++i) {
-        items_[j].alternatives[i].j = j;
-        items_[j].alternatives[i].i = i;
-    }
+    Data& d = data();
+    assert(d.layout == MatrixLayout::ItemMajor);
+    ItemIdx j = d.items.size();
+    d.items.push_back({});
+    d.items[j].j = j;
+    d.weights.resize(d.weights.size() + agent_number());
+    d.costs.resize(d.costs.size() + agent_number());
+    d.candidate_agents_start.clear();
+    d.eligibility.outdated = true;
 }
 
 void Instance::set_alternative(ItemIdx j, AgentIdx i, Weight w, Cost v)
 {
-    items_[j].alternatives[i].w = w;
-    items_[j].alternatives[i].c = v;
-    items_[j].w += w;
-    items_[j].c += v;
-    if (items_[j].i_cmin != -1 && items_[j].c_min > v)
-        c_min_sum_ -= items_[j].c_min;
-    if (items_[j].i_cmin == -1 || items_[j].c_min > v) {
-        items_[j].i_cmin = i;
-        items_[j].c_min = v;
-        c_min_sum_ += v;
-    }
-    if (items_[j].i_wmin == -1 || items_[j].w_min > w) {
-        items_[j].i_wmin = i;
-        items_[j].w_min = w;
-    }
-    if (items_[j].c_max < v) {
-        items_[j].i_cmax = i;
-        items_[j].c_max = v;
-    }
-    if (items_[j].w_max < w) {
-        items_[j].i_wmax = i;
-        items_[j].w_max = w;
-    }
-    if (c_max_ < v)
-        c_max_ = v;
-    if (w_max_ < w)
-        w_max_ = w;
-    c_tot_ += v;
+    set_alternative_statistics(j, i, w, v);
+    data_->candidate_agents_start.clear();
+    data_->eligibility.outdated = true;
+}
+
+void Instance::set_alternative_statistics(ItemIdx j, AgentIdx i, Weight w, Cost v)
+{
+    Data& d = data();
+    Item& item = d.items[j];
+    d.weights.set(position(j, i), w);
+    d.costs.set(position(j, i), v);
+    item.w += w;
+    item.c += v;
+    if (item.i_cmin != -1 && item.c_min > v)
+        d.c_min_sum -= item.c_min;
+    if (item.i_cmin == -1 || item.c_min > v) {
+        item.i_cmin = i;
+        item.c_min = v;
+        d.c_min_sum += v;
+    }
+    if (item.i_wmin == -1 || item.w_min > w) {
+        item.i_wmin = i;
+        item.w_min = w;
+    }
+    if (item.c_max < v) {
+        item.i_cmax = i;
+        item.c_max = v;
+    }
+    if (item.w_max < w) {
+        item.i_wmax = i;
+        item.w_max = w;
+    }
+    if (d.c_max < v)
+        d.c_max = v;
+    if (d.w_max < w)
+        d.w_max = w;
+    d.c_tot += v;
 }
 
+/**
+ * Builder for large instances.
+ *
+ * The number of items and agents are given at construction, the matrices are
+ * filled alternative by alternative, item by item, agent by agent or directly
+ * from external buffers, and the statistics of the items are computed once
+ * by build().
+ */
+class InstanceBuilder
+{
+
+public:
+
+    /**
+     * Create a builder for an instance with n items and m agents, whose
+     * matrices are stored according to 'layout'.
+     */
+    InstanceBuilder(ItemIdx n, AgentIdx m, MatrixLayout layout = MatrixLayout::ItemMajor);
+
+    void set_name(std::string name) { instance_.data_->name = name; }
+    void set_capacity(AgentIdx i, Weight t) { instance_.data_->capacities[i] = t; }
+    void set_capacities(const Weight* t);
+
+    inline void set_alternative(ItemIdx j, AgentIdx i, Weight w, Cost c)
+    {
+        instance_.data_->weights.set(instance_.position(j, i), w);
+        instance_.data_->costs.set(instance_.position(j, i), c);
+    }
+
+    /**
+     * Remove alternative (j, i): it is not eligible anymore, but its weight
+     * and cost are kept, so that the statistics of the instance are
+     * unchanged.
+     */
+    void remove_alternative(ItemIdx j, AgentIdx i);
+
+    /** Set the weights and costs of item j; arrays of size m. */
+    void set_item(ItemIdx j, const Weight* weights, const Cost* costs);
+    /** Set the weights and costs of agent i; arrays of size n. */
+    void set_agent(AgentIdx i, const Weight* weights, const Cost* costs);
+
+    /**
+     * Use an external buffer of n * m values stored according to the layout
+     * of the builder as weight (resp. cost) matrix, without copying it.
+     *
+     * 'owner' keeps the buffer alive. If it is null, the buffer must outlive
+     * the built instance and all its copies.
+     */
+    template <typename T>
+    void set_weights(const T* weights, std::shared_ptr<const void> owner = nullptr)
+    {
+        set_view(instance_.data_->weights, weights, owner);
+    }
+    template <typename T>
+    void set_costs(const T* costs, std::shared_ptr<const void> owner = nullptr)
+    {
+        set_view(instance_.data_->costs, costs, owner);
+    }
+
+    /** Compute the statistics and return the instance. */
+    Instance build();
+
+private:
+
+    template <typename T>
+    void set_view(IntegerArray& array, const T* data, std::shared_ptr<const void> owner)
+    {
+        static_assert(std::is_same<T, int16_t>::value
+                || std::is_same<T, int32_t>::value
+                || std::is_same<T, int64_t>::value,
+                "Buffers must contain int16_t, int32_t or int64_t values.");
+        if (owner == nullptr)
+            owner = std::shared_ptr<const void>(data, [](const void*) { });
+        array.set_view(
+                reinterpret_cast<const char*>(data),
+                instance_.item_number() * instance_.agent_number(),
+                sizeof(T),
+                owner);
+    }
+
+    Instance instance_;
+
+};
+
 std::ostream& operator<<(std::ostream &os, const Alternative& alternative);
 std::ostream& operator<<(std::ostream &os, const Instance& instance);
 
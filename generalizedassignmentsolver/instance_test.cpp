@@ -0,0 +1,222 @@
+#include "generalizedassignmentsolver/instance.hpp"
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <thread>
+
+using namespace generalizedassignmentsolver;
+
+/**
+ * Instance with 7 items and 3 agents; some alternatives are not eligible and
+ * the costs do not fit on 2 bytes.
+ */
+Instance instance_test()
+{
+    InstanceBuilder builder(7, 3);
+    builder.set_capacity(0, 20);
+    builder.set_capacity(1, 15);
+    builder.set_capacity(2, 30);
+    for (ItemIdx j = 0; j < 7; ++j)
+        for (AgentIdx i = 0; i < 3; ++i)
+            builder.set_alternative(j, i, 3 + (5 * j + 7 * i) % 17, 40000 + 1000 * ((3 * j + i) % 11));
+    return builder.build();
+}
+
+void instance_expect_eq(const Instance& instance_1, const Instance& instance_2)
+{
+    ASSERT_EQ(instance_1.item_number(), instance_2.item_number());
+    ASSERT_EQ(instance_1.agent_number(), instance_2.agent_number());
+    for (AgentIdx i = 0; i < instance_1.agent_number(); ++i)
+        EXPECT_EQ(instance_1.capacity(i), instance_2.capacity(i));
+    for (ItemIdx j = 0; j < instance_1.item_number(); ++j) {
+        for (AgentIdx i = 0; i < instance_1.agent_number(); ++i) {
+            EXPECT_EQ(instance_1.weight(j, i), instance_2.weight(j, i));
+            EXPECT_EQ(instance_1.cost(j, i), instance_2.cost(j, i));
+        }
+        auto agents_1 = instance_1.eligible_agents(j);
+        auto agents_2 = instance_2.eligible_agents(j);
+        EXPECT_EQ(std::vector<AgentIdx>(agents_1.begin(), agents_1.end()),
+                std::vector<AgentIdx>(agents_2.begin(), agents_2.end()));
+        EXPECT_EQ(instance_1.item(j).c_min, instance_2.item(j).c_min);
+        EXPECT_EQ(instance_1.item(j).w_max, instance_2.item(j).w_max);
+    }
+    EXPECT_EQ(instance_1.cost_max(), instance_2.cost_max());
+    EXPECT_EQ(instance_1.weight_max(), instance_2.weight_max());
+    EXPECT_EQ(instance_1.combinatorial_relaxation(), instance_2.combinatorial_relaxation());
+    EXPECT_EQ(instance_1.bound(), instance_2.bound());
+}
+
+TEST(Instance, OrLibraryRoundTrip)
+{
+    Instance instance = instance_test();
+    std::string filepath = testing::TempDir() + "instance_orlibrary.txt";
+    instance.write(filepath, "orlibrary");
+    Instance instance_read(filepath, "orlibrary");
+    instance_expect_eq(instance, instance_read);
+}
+
+TEST(Instance, Standard)
+{
+    Instance instance = instance_test();
+    std::string filepath = testing::TempDir() + "instance_standard.txt";
+    {
+        std::ofstream file(filepath);
+        file << instance.agent_number() << " " << instance.item_number() << "\n";
+        for (AgentIdx i = 0; i < instance.agent_number(); ++i)
+            file << instance.capacity(i) << " ";
+        file << "\n";
+        for (ItemIdx j = 0; j < instance.item_number(); ++j) {
+            for (AgentIdx i = 0; i < instance.agent_number(); ++i)
+                file << instance.weight(j, i) << " " << instance.cost(j, i) << "\t";
+            file << "\r\n";
+        }
+    }
+    Instance instance_read(filepath, "standard");
+    instance_expect_eq(instance, instance_read);
+}
+
+TEST(Instance, TruncatedFile)
+{
+    Instance instance = instance_test();
+    std::string filepath = testing::TempDir() + "instance_truncated.txt";
+    instance.write(filepath, "orlibrary");
+    std::string content;
+    {
+        std::ifstream file(filepath);
+        content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    {
+        std::ofstream file(filepath);
+        file << content.substr(0, content.size() / 2);
+    }
+    EXPECT_THROW(Instance(filepath, "orlibrary"), std::runtime_error);
+    EXPECT_THROW(Instance(testing::TempDir() + "instance_missing.txt"), std::runtime_error);
+}
+
+TEST(Instance, BinaryRoundTrip)
+{
+    for (MatrixLayout layout: {MatrixLayout::ItemMajor, MatrixLayout::AgentMajor}) {
+        Instance instance = instance_test();
+        instance.set_matrix_layout(layout);
+        std::string filepath = testing::TempDir() + "instance.bin";
+        instance.write(filepath, "binary");
+        Instance instance_read(filepath, "binary");
+        EXPECT_EQ(instance_read.matrix_layout(), layout);
+        EXPECT_EQ(instance_read.weight_width(), instance.weight_width());
+        EXPECT_EQ(instance_read.cost_width(), instance.cost_width());
+        instance_expect_eq(instance, instance_read);
+    }
+}
+
+/**
+ * Write instance_test() in binary format, overwrite 'size' bytes at 'offset'
+ * with 'value' and expect reading it to throw.
+ */
+void instance_binary_expect_throw(std::size_t offset, int64_t value, std::size_t size)
+{
+    Instance instance = instance_test();
+    std::string filepath = testing::TempDir() + "instance_corrupted.bin";
+    instance.write(filepath, "binary");
+    {
+        std::fstream file(filepath, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(offset);
+        file.write(reinterpret_cast<const char*>(&value), size);
+    }
+    EXPECT_THROW(Instance(filepath, "binary"), std::runtime_error);
+}
+
+TEST(Instance, BinaryInvalidHeader)
+{
+    // Offsets of the fields of the header.
+    instance_binary_expect_throw(0, 0, 4); // magic
+    instance_binary_expect_throw(4, 2, 4); // version
+    instance_binary_expect_throw(12, 7, 4); // layout
+    instance_binary_expect_throw(16, 3, 4); // weight width
+    instance_binary_expect_throw(20, 16, 4); // cost width
+    instance_binary_expect_throw(24, -1, 8); // agent number
+    instance_binary_expect_throw(32, (int64_t)1 << 61, 8); // item number
+    instance_binary_expect_throw(72, 1 << 20, 8); // weights offset
+    instance_binary_expect_throw(80, 8, 8); // costs offset
+}
+
+TEST(Instance, BinaryTruncatedFile)
+{
+    Instance instance = instance_test();
+    std::string filepath = testing::TempDir() + "instance_truncated.bin";
+    instance.write(filepath, "binary");
+    std::string content;
+    {
+        std::ifstream file(filepath, std::ios::binary);
+        content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    for (std::size_t size: {(std::size_t)40, (std::size_t)200, content.size() - 1}) {
+        {
+            std::ofstream file(filepath, std::ios::binary);
+            file.write(content.data(), size);
+        }
+        EXPECT_THROW(Instance(filepath, "binary"), std::runtime_error);
+    }
+}
+
+std::vector<AgentIdx> instance_eligible_agents(const Instance& instance, ItemIdx j)
+{
+    auto agents = instance.eligible_agents(j);
+    return std::vector<AgentIdx>(agents.begin(), agents.end());
+}
+
+TEST(Instance, EligibilityAfterModification)
+{
+    Instance instance(3);
+    instance.set_capacities({5, 7, 4});
+    instance.add_item({{3, 10}, {8, 11}, {4, 9}});
+    instance.add_item({{6, 10}, {2, 11}, {5, 9}});
+    EXPECT_EQ(instance_eligible_agents(instance, 0), (std::vector<AgentIdx>{0, 2}));
+    EXPECT_EQ(instance_eligible_agents(instance, 1), (std::vector<AgentIdx>{1}));
+
+    // Modifying a copy updates its eligible alternatives but not the ones of
+    // the instances sharing its payload.
+    Instance instance_copy = instance;
+    instance_copy.set_capacity(2, 3);
+    instance_copy.set_alternative(1, 0, 5, 12);
+    EXPECT_EQ(instance_eligible_agents(instance_copy, 0), (std::vector<AgentIdx>{0}));
+    EXPECT_EQ(instance_eligible_agents(instance_copy, 1), (std::vector<AgentIdx>{0, 1}));
+    EXPECT_EQ(instance_eligible_agents(instance, 0), (std::vector<AgentIdx>{0, 2}));
+    EXPECT_EQ(instance_eligible_agents(instance, 1), (std::vector<AgentIdx>{1}));
+    auto items = instance_copy.eligible_items(0);
+    EXPECT_EQ(std::vector<ItemIdx>(items.begin(), items.end()), (std::vector<ItemIdx>{0, 1}));
+}
+
+TEST(Instance, EligibilityConcurrentReaders)
+{
+    // The eligible alternatives of a modified instance are recomputed by the
+    // first of its concurrent readers, while a copy is modified.
+    Instance instance(4);
+    instance.set_capacities({10, 10, 10, 10});
+    for (ItemIdx j = 0; j < 100; ++j) {
+        instance.add_item();
+        for (AgentIdx i = 0; i < 4; ++i)
+            instance.set_alternative(j, i, (j + i) % 12, 1);
+    }
+    ItemPos size = 0;
+    for (ItemIdx j = 0; j < instance.item_number(); ++j)
+        for (AgentIdx i = 0; i < instance.agent_number(); ++i)
+            size += instance.eligible(j, i);
+
+    Instance instance_copy = instance;
+    std::vector<std::thread> threads;
+    std::vector<ItemPos> sizes(4, 0);
+    for (Counter t = 0; t < 4; ++t) {
+        threads.push_back(std::thread([&instance, &sizes, t]()
+        {
+            for (ItemIdx j = 0; j < instance.item_number(); ++j)
+                sizes[t] += instance.eligible_agents(j).size();
+        }));
+    }
+    instance_copy.set_capacity(0, 0);
+    for (std::thread& thread: threads)
+        thread.join();
+    for (Counter t = 0; t < 4; ++t)
+        EXPECT_EQ(sizes[t], size);
+    EXPECT_EQ(instance_copy.eligible_items(0).size(), 9);
+}
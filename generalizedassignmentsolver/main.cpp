@@ -1,4 +1,8 @@
 #include "generalizedassignmentsolver/algorithms/algorithms.hpp"
+#include "generalizedassignmentsolver/algorithms/greedy.hpp"
+#include "generalizedassignmentsolver/algorithms/lagrelax_lbfgs.hpp"
+#include "generalizedassignmentsolver/reduction.hpp"
+#include "generalizedassignmentsolver/desirability.hpp"
 
 #include <boost/program_options.hpp>
 
@@ -13,9 +17,14 @@ int main(int argc, char *argv[])
     std::string algorithm = "branchandcut_cbc";
     std::string instance_path = "";
     std::string format = "orlibrary";
+    MatrixLayout matrix_layout = MatrixLayout::ItemMajor;
     std::string output_path = "";
+    std::string instance_output_path = "";
+    std::string instance_output_format = "binary";
     std::string initial_solution_path = "";
     std::string certificate_path = "";
+    AgentPos candidate_agent_number = 0;
+    std::string candidate_desirability = "cij";
     std::string log_path = "";
     int loglevelmax = 999;
     int seed = 0;
@@ -27,8 +36,16 @@ int main(int argc, char *argv[])
         ("algorithm,a", po::value<std::string>(&algorithm), "set algorithm")
         ("input,i", po::value<std::string>(&instance_path)->required(), "set input file (required)")
         ("format,f", po::value<std::string>(&format), "set input file format (default: orlibrary)")
+        ("matrix-layout", po::value<MatrixLayout>(&matrix_layout), "set weight and cost matrices layout: item-major, agent-major (default: item-major)")
         ("initial-solution", po::value<std::string>(&initial_solution_path), "set initial solution file")
         ("output,o", po::value<std::string>(&output_path), "set output file")
+        ("instance-output", po::value<std::string>(&instance_output_path), "write the instance to this file before solving it")
+        ("instance-output-format", po::value<std::string>(&instance_output_format), "set instance output file format (default: binary)")
+        ("reduce", "remove the alternatives which cannot be part of a feasible solution before solving")
+        ("remove-dominated-alternatives", "also remove dominated alternatives (heuristic, implies --reduce)")
+        ("reduced-cost-fixing", "also remove the alternatives which cannot lead to a solution better than the initial solution, or than the one of mthgregret, according to the reduced costs of lagrelax_knapsack_lbfgs (implies --reduce)")
+        ("candidate-agents", po::value<AgentPos>(&candidate_agent_number), "only move items to their k most desirable agents in the neighborhoods of localsearch, mthg, mthgregret, repair and random (default: 0, all agents)")
+        ("candidate-desirability", po::value<std::string>(&candidate_desirability), "set the desirability function of the candidate agents (default: cij)")
         ("certificate,c", po::value<std::string>(&certificate_path), "set certificate file")
         ("time-limit,t", po::value<double>(&time_limit), "Time limit in seconds\n  ex: 3600")
         ("seed,s", po::value<int>(&seed), "seed")
@@ -55,6 +72,52 @@ int main(int argc, char *argv[])
     std::mt19937_64 gen(seed);
 
     Instance instance(instance_path, format);
+    instance.set_matrix_layout(matrix_layout);
+    if (!instance_output_path.empty())
+        instance.write(instance_output_path, instance_output_format);
+    ItemIdx fixed_item_number = 0;
+    Counter removed_alternative_number = 0;
+    bool reduction_enabled = vm.count("reduce")
+        || vm.count("remove-dominated-alternatives")
+        || vm.count("reduced-cost-fixing");
+    if (reduction_enabled) {
+        ReductionOptionalParameters parameters_reduction;
+        parameters_reduction.remove_dominated_alternatives = vm.count("remove-dominated-alternatives");
+        Reduction reduction = reduce(instance, parameters_reduction);
+        // Items keep their indices, so the solutions and certificates of the
+        // reduced instance are valid for the original one.
+        instance = reduction.instance;
+        fixed_item_number = reduction.fixed_item_number;
+        removed_alternative_number = reduction.removed_alternative_number;
+    }
+    if (vm.count("reduced-cost-fixing")) {
+        Cost upper_bound = -1;
+        {
+            Solution solution(instance, initial_solution_path);
+            if (solution.feasible())
+                upper_bound = solution.cost();
+            Output output_greedy = mthgregret(instance, *desirability("cij", instance), Info());
+            if (output_greedy.solution.feasible()
+                    && (upper_bound == -1 || upper_bound > output_greedy.solution.cost()))
+                upper_bound = output_greedy.solution.cost();
+        }
+        if (upper_bound != -1) {
+            auto output_lagrelax = lagrelax_knapsack_lbfgs(instance, Info());
+            // Keep the solutions as good as the upper bound, so that the
+            // solution which gave it remains feasible.
+            std::vector<std::vector<int>> fixed_alt = reduced_cost_fixing(
+                    instance,
+                    output_lagrelax.value,
+                    output_lagrelax.reduced_costs,
+                    upper_bound + 1);
+            Reduction reduction = reduce(instance, fixed_alt);
+            instance = reduction.instance;
+            fixed_item_number = reduction.fixed_item_number;
+            removed_alternative_number += reduction.removed_alternative_number;
+        }
+    }
+    if (candidate_agent_number > 0)
+        instance.set_candidate_agents(*desirability(candidate_desirability, instance), candidate_agent_number);
     Solution initial_solution(instance, initial_solution_path);
 
     Info info = Info()
@@ -70,6 +133,10 @@ int main(int argc, char *argv[])
 
     VER(info, "Agents:  " << instance.agent_number() << std::endl);
     VER(info, "Items:   " << instance.item_number() << std::endl);
+    if (reduction_enabled) {
+        VER(info, "Fixed items:          " << fixed_item_number << std::endl);
+        VER(info, "Removed alternatives: " << removed_alternative_number << std::endl);
+    }
 
     run(algorithm, instance, initial_solution, gen, info);
 
@@ -0,0 +1,63 @@
+#include "generalizedassignmentsolver/mappedfile.hpp"
+
+#include <fstream>
+#include <iterator>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MMAP_FOUND 1
+#endif
+
+using namespace generalizedassignmentsolver;
+
+MappedFile::MappedFile(std::string filepath)
+{
+#if MMAP_FOUND
+    int fd = open(filepath.c_str(), O_RDONLY);
+    if (fd == -1)
+        return;
+    struct stat sb;
+    if (fstat(fd, &sb) == -1) {
+        close(fd);
+        return;
+    }
+    size_ = sb.st_size;
+    if (size_ == 0) {
+        close(fd);
+        good_ = true;
+        return;
+    }
+    void* p = mmap(NULL, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p != MAP_FAILED) {
+        madvise(p, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(p);
+        mapped_ = true;
+        good_ = true;
+        return;
+    }
+#endif
+
+    // Fallback: read the whole file.
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file.good())
+        return;
+    buffer_.assign(
+            std::istreambuf_iterator<char>(file),
+            std::istreambuf_iterator<char>());
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+    good_ = true;
+}
+
+MappedFile::~MappedFile()
+{
+#if MMAP_FOUND
+    if (mapped_)
+        munmap(const_cast<char*>(data_), size_);
+#endif
+}
+
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace generalizedassignmentsolver
+{
+
+/**
+ * Read-only view of the content of a file.
+ *
+ * The file is memory-mapped when the platform supports it; otherwise, its
+ * content is read into a buffer.
+ */
+class MappedFile
+{
+
+public:
+
+    MappedFile(std::string filepath);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool good() const { return good_; }
+    const char* data() const { return data_; }
+    std::size_t size() const { return size_; }
+
+private:
+
+    bool good_ = false;
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+    bool mapped_ = false;
+    std::vector<char> buffer_;
+
+};
+
+}
+
@@ -0,0 +1,222 @@
+#include "generalizedassignmentsolver/reduction.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace generalizedassignmentsolver;
+
+Solution Reduction::solution(const Instance& original, const Solution& solution) const
+{
+    Solution solution_original(original);
+    for (ItemIdx j = 0; j < original.item_number(); ++j)
+        if (solution.agent(j) != -1)
+            solution_original.set(j, solution.agent(j));
+    return solution_original;
+}
+
+/**
+ * Build the reduction of 'instance' which only keeps the alternatives (j, i)
+ * with i in agents[j].
+ */
+Reduction reduced_instance(
+        const Instance& instance,
+        const std::vector<std::vector<AgentIdx>>& agents,
+        const std::vector<AgentIdx>& fixed_agents,
+        bool exact)
+{
+    ItemIdx n = instance.item_number();
+    AgentIdx m = instance.agent_number();
+    InstanceBuilder builder(n, m, instance.matrix_layout());
+    builder.set_name(instance.name());
+    for (AgentIdx i = 0; i < m; ++i)
+        builder.set_capacity(i, instance.capacity(i));
+    std::vector<int8_t> kept(m);
+    Counter removed_alternative_number = 0;
+    ItemIdx fixed_item_number = 0;
+    for (ItemIdx j = 0; j < n; ++j) {
+        if (fixed_agents[j] != -1)
+            fixed_item_number++;
+        std::fill(kept.begin(), kept.end(), 0);
+        for (AgentIdx i: agents[j])
+            kept[i] = 1;
+        for (AgentIdx i = 0; i < m; ++i) {
+            builder.set_alternative(j, i, instance.weight(j, i), instance.cost(j, i));
+            // The alternatives which don't fit are not eligible anyway; the
+            // other ones which are not kept are removed, including those
+            // already removed from the original instance.
+            if (kept[i] || instance.weight(j, i) > instance.capacity(i))
+                continue;
+            builder.remove_alternative(j, i);
+            if (instance.eligible(j, i))
+                removed_alternative_number++;
+        }
+    }
+
+    return {
+        builder.build(),
+        fixed_agents,
+        fixed_item_number,
+        removed_alternative_number,
+        exact,
+    };
+}
+
+Reduction generalizedassignmentsolver::reduce(
+        const Instance& instance,
+        ReductionOptionalParameters parameters)
+{
+    ItemIdx n = instance.item_number();
+    AgentIdx m = instance.agent_number();
+
+    // remaining_capacities[i] is the capacity of agent i minus the weights of
+    // the items fixed to it.
+    std::vector<Weight> remaining_capacities(m);
+    for (AgentIdx i = 0; i < m; ++i)
+        remaining_capacities[i] = instance.capacity(i);
+    std::vector<AgentIdx> fixed_agents(n, -1);
+    // agents[j] contains the remaining agents of item j.
+    std::vector<std::vector<AgentIdx>> agents(n);
+    for (ItemIdx j = 0; j < n; ++j) {
+        auto eligible_agents = instance.eligible_agents(j);
+        agents[j].assign(eligible_agents.begin(), eligible_agents.end());
+    }
+
+    std::vector<AgentIdx> sorted_agents;
+    for (bool reduced = true; reduced;) {
+        reduced = false;
+        for (ItemIdx j = 0; j < n; ++j) {
+            if (fixed_agents[j] != -1)
+                continue;
+            std::vector<AgentIdx>& agents_j = agents[j];
+
+            // Remove the alternatives which don't fit anymore.
+            auto it = std::remove_if(agents_j.begin(), agents_j.end(),
+                    [&instance, &remaining_capacities, j](AgentIdx i)
+                    { return instance.weight(j, i) > remaining_capacities[i]; });
+            if (it != agents_j.end()) {
+                agents_j.erase(it, agents_j.end());
+                reduced = true;
+            }
+
+            // Remove the dominated alternatives. Alternatives are sorted by
+            // cost, then by weight relative to the capacity; an alternative
+            // is dominated if one of the previous ones has a lower relative
+            // weight.
+            if (parameters.remove_dominated_alternatives && agents_j.size() > 1) {
+                auto relative_weight = [&instance, j](AgentIdx i)
+                {
+                    return (double)instance.weight(j, i) / instance.capacity(i);
+                };
+                sorted_agents = agents_j;
+                std::sort(sorted_agents.begin(), sorted_agents.end(),
+                        [&instance, &relative_weight, j](AgentIdx i1, AgentIdx i2) -> bool
+                        {
+                            if (instance.cost(j, i1) != instance.cost(j, i2))
+                                return instance.cost(j, i1) < instance.cost(j, i2);
+                            return relative_weight(i1) < relative_weight(i2);
+                        });
+                double relative_weight_min = relative_weight(sorted_agents[0]);
+                agents_j = {sorted_agents[0]};
+                for (auto it = sorted_agents.begin() + 1; it != sorted_agents.end(); ++it) {
+                    double r = relative_weight(*it);
+                    if (r >= relative_weight_min) {
+                        reduced = true;
+                        continue;
+                    }
+                    relative_weight_min = r;
+                    agents_j.push_back(*it);
+                }
+                std::sort(agents_j.begin(), agents_j.end());
+            }
+
+            // Fix the item if it has a single alternative left.
+            if (agents_j.size() == 1) {
+                AgentIdx i = agents_j[0];
+                fixed_agents[j] = i;
+                remaining_capacities[i] -= instance.weight(j, i);
+                reduced = true;
+            }
+        }
+    }
+
+    return reduced_instance(
+            instance,
+            agents,
+            fixed_agents,
+            !parameters.remove_dominated_alternatives);
+}
+
+std::vector<std::vector<int>> generalizedassignmentsolver::reduced_cost_fixing(
+        const Instance& instance,
+        double lower_bound,
+        const std::vector<std::vector<double>>& reduced_costs,
+        Cost upper_bound)
+{
+    ItemIdx n = instance.item_number();
+    AgentIdx m = instance.agent_number();
+    std::vector<std::vector<int>> fixed_alt(n, std::vector<int>(m, 0));
+
+    // Fix to 0 the alternatives which cannot lead to an improving solution.
+    // Costs are integral, so an improving solution costs at most
+    // upper_bound - 1.
+    for (ItemIdx j = 0; j < n; ++j)
+        for (AgentIdx i: instance.eligible_agents(j))
+            if (std::ceil(lower_bound + reduced_costs[j][i] - TOL) < upper_bound)
+                fixed_alt[j][i] = -1;
+
+    // Fix the items with a single alternative left, and propagate the
+    // capacities.
+    std::vector<Weight> remaining_capacities(m);
+    for (AgentIdx i = 0; i < m; ++i)
+        remaining_capacities[i] = instance.capacity(i);
+    std::vector<int8_t> fixed_items(n, 0);
+    for (bool reduced = true; reduced;) {
+        reduced = false;
+        for (ItemIdx j = 0; j < n; ++j) {
+            if (fixed_items[j])
+                continue;
+            AgentIdx i_last = -1;
+            AgentIdx alternative_number = 0;
+            for (AgentIdx i: instance.eligible_agents(j)) {
+                if (fixed_alt[j][i] != -1)
+                    continue;
+                if (instance.weight(j, i) > remaining_capacities[i]) {
+                    fixed_alt[j][i] = 0;
+                    reduced = true;
+                    continue;
+                }
+                i_last = i;
+                alternative_number++;
+            }
+            if (alternative_number == 1) {
+                fixed_alt[j][i_last] = 1;
+                fixed_items[j] = 1;
+                remaining_capacities[i_last] -= instance.weight(j, i_last);
+                reduced = true;
+            }
+        }
+    }
+
+    return fixed_alt;
+}
+
+Reduction generalizedassignmentsolver::reduce(
+        const Instance& instance,
+        const std::vector<std::vector<int>>& fixed_alt)
+{
+    ItemIdx n = instance.item_number();
+    std::vector<AgentIdx> fixed_agents(n, -1);
+    std::vector<std::vector<AgentIdx>> agents(n);
+    for (ItemIdx j = 0; j < n; ++j) {
+        for (AgentIdx i: instance.eligible_agents(j)) {
+            if (fixed_alt[j][i] == 1)
+                fixed_agents[j] = i;
+            if (fixed_alt[j][i] != 0)
+                agents[j].push_back(i);
+        }
+        if (fixed_agents[j] != -1)
+            agents[j] = {fixed_agents[j]};
+    }
+    return reduced_instance(instance, agents, fixed_agents, true);
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "generalizedassignmentsolver/solution.hpp"
+
+namespace generalizedassignmentsolver
+{
+
+struct ReductionOptionalParameters
+{
+    /**
+     * Also remove the alternatives (j, i) dominated by another alternative
+     * (j, i') with a lower cost and a lower weight relative to the capacity.
+     *
+     * This reduction is heuristic: it may remove all the optimal solutions,
+     * and the bounds computed on the reduced instance are not valid for the
+     * original one.
+     */
+    bool remove_dominated_alternatives = false;
+};
+
+/**
+ * Reduced instance.
+ *
+ * Items and agents keep their indices, as well as their capacities, weights
+ * and costs; the removed alternatives are marked as not eligible (see
+ * InstanceBuilder::remove_alternative). Therefore, a feasible solution of the
+ * reduced instance is a feasible solution of the original instance with the
+ * same cost, and solution() maps it back to the original instance.
+ */
+struct Reduction
+{
+    Instance instance;
+
+    /** fixed_agents[j] is the agent to which item j is fixed, -1 if none. */
+    std::vector<AgentIdx> fixed_agents;
+    ItemIdx fixed_item_number = 0;
+    Counter removed_alternative_number = 0;
+
+    /** Whether the reduced instance has the same optimal solutions. */
+    bool exact = true;
+
+    /** Return the solution of 'original' corresponding to 'solution'. */
+    Solution solution(const Instance& original, const Solution& solution) const;
+};
+
+/**
+ * Reduce an instance.
+ *
+ * The following rules are applied until no alternative is removed:
+ * - an alternative (j, i) such that wij is greater than the capacity of i
+ *   minus the weights of the items fixed to i is removed;
+ * - an item with a single remaining alternative is fixed to its agent;
+ * - if enabled, dominated alternatives are removed.
+ */
+Reduction reduce(
+        const Instance& instance,
+        ReductionOptionalParameters parameters = {});
+
+/**
+ * Reduced cost fixing.
+ *
+ * 'reduced_costs[j][i]' is a lower bound on the increase of 'lower_bound'
+ * when xij is fixed to 1, for example the reduced costs of a Lagrangian
+ * relaxation (see LagRelaxKnapsackLbfgsOutput::reduced_costs). 'lower_bound'
+ * must be the unrounded value of the relaxation they come from (see
+ * LagRelaxKnapsackLbfgsOutput::value): the bound of xij = 1 is rounded up
+ * once the reduced cost is added.
+ *
+ * Returns a matrix fixed_alt with fixed_alt[j][i] = -1 if xij is not fixed,
+ * 0 if it is fixed to 0 and 1 if it is fixed to 1. xij is fixed to 0 if
+ * fixing it to 1 cannot lead to a solution strictly better than
+ * 'upper_bound', or if wij does not fit in the capacity of agent i left by
+ * the items fixed to it. An item whose alternatives are all fixed to 0 but
+ * one is fixed to it.
+ */
+std::vector<std::vector<int>> reduced_cost_fixing(
+        const Instance& instance,
+        double lower_bound,
+        const std::vector<std::vector<double>>& reduced_costs,
+        Cost upper_bound);
+
+/**
+ * Reduce an instance according to a matrix fixed_alt as returned by
+ * reduced_cost_fixing(): the alternatives fixed to 0 are removed, and the
+ * items fixed to an agent only keep this alternative.
+ *
+ * The reduced instance keeps the solutions of the original instance which
+ * respect the fixings, e.g. every solution strictly better than the upper
+ * bound given to reduced_cost_fixing().
+ */
+Reduction reduce(
+        const Instance& instance,
+        const std::vector<std::vector<int>>& fixed_alt);
+
+}
@@ -0,0 +1,338 @@
+#include "generalizedassignmentsolver/reduction.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <random>
+
+using namespace generalizedassignmentsolver;
+
+/**
+ * Random instance with tight capacities, so that many alternatives do not fit
+ * and items get fixed.
+ */
+Instance reduction_instance_test(ItemIdx n, AgentIdx m, Seed seed)
+{
+    std::mt19937_64 generator(seed);
+    std::uniform_int_distribution<Weight> d_weight(1, 20);
+    std::uniform_int_distribution<Weight> d_capacity(10, 30);
+    std::uniform_int_distribution<Cost> d_cost(1, 50);
+    InstanceBuilder builder(n, m);
+    for (AgentIdx i = 0; i < m; ++i)
+        builder.set_capacity(i, d_capacity(generator));
+    for (ItemIdx j = 0; j < n; ++j)
+        for (AgentIdx i = 0; i < m; ++i)
+            builder.set_alternative(j, i, d_weight(generator), d_cost(generator));
+    return builder.build();
+}
+
+/**
+ * Call 'function' on every feasible assignment of 'instance', i.e. every
+ * assignment of each item to one of its eligible agents which respects the
+ * capacities.
+ */
+template <typename Function>
+void reduction_enumerate(const Instance& instance, Function function)
+{
+    ItemIdx n = instance.item_number();
+    Solution solution(instance);
+    std::function<void(ItemIdx)> enumerate = [&](ItemIdx j)
+    {
+        if (j == n) {
+            if (solution.feasible())
+                function(solution);
+            return;
+        }
+        for (AgentIdx i: instance.eligible_agents(j)) {
+            solution.set(j, i);
+            if (solution.remaining_capacity(i) >= 0)
+                enumerate(j + 1);
+        }
+        solution.set(j, -1);
+    };
+    enumerate(0);
+}
+
+TEST(Reduction, Reduce)
+{
+    ItemIdx fixed_item_number = 0;
+    Counter removed_alternative_number = 0;
+    Counter feasible_instance_number = 0;
+    for (Seed seed = 0; seed < 20; ++seed) {
+        Instance instance = reduction_instance_test(8, 3, seed);
+        Reduction reduction = reduce(instance);
+        const Instance& instance_reduced = reduction.instance;
+        EXPECT_TRUE(reduction.exact);
+        fixed_item_number += reduction.fixed_item_number;
+        removed_alternative_number += reduction.removed_alternative_number;
+
+        // The weights and costs are kept, only the eligibility changes.
+        Counter removed = 0;
+        for (ItemIdx j = 0; j < instance.item_number(); ++j) {
+            for (AgentIdx i = 0; i < instance.agent_number(); ++i) {
+                EXPECT_EQ(instance_reduced.weight(j, i), instance.weight(j, i));
+                EXPECT_EQ(instance_reduced.cost(j, i), instance.cost(j, i));
+                if (instance.eligible(j, i) && !instance_reduced.eligible(j, i))
+                    removed++;
+                EXPECT_FALSE(!instance.eligible(j, i) && instance_reduced.eligible(j, i));
+            }
+        }
+        EXPECT_EQ(removed, reduction.removed_alternative_number);
+        EXPECT_EQ(instance_reduced.weight_max(), instance.weight_max());
+        EXPECT_EQ(instance_reduced.cost_max(), instance.cost_max());
+
+        // Every feasible solution of the original instance uses the fixed
+        // agents and no removed alternative.
+        Cost opt = instance.bound();
+        reduction_enumerate(instance, [&](const Solution& solution)
+        {
+            opt = std::min(opt, solution.cost());
+            for (ItemIdx j = 0; j < instance.item_number(); ++j) {
+                AgentIdx i = solution.agent(j);
+                EXPECT_TRUE(instance_reduced.eligible(j, i));
+                if (reduction.fixed_agents[j] != -1) {
+                    EXPECT_EQ(i, reduction.fixed_agents[j]);
+                }
+            }
+        });
+
+        // Hence the reduced instance has the same optimal value.
+        Cost opt_reduced = instance.bound();
+        reduction_enumerate(instance_reduced, [&](const Solution& solution)
+        {
+            Solution solution_original = reduction.solution(instance, solution);
+            EXPECT_TRUE(solution_original.feasible());
+            EXPECT_EQ(solution_original.cost(), solution.cost());
+            opt_reduced = std::min(opt_reduced, solution.cost());
+        });
+        EXPECT_EQ(opt_reduced, opt);
+        if (opt != instance.bound())
+            feasible_instance_number++;
+    }
+    // Make sure the instances are actually reduced.
+    EXPECT_GT(fixed_item_number, 0);
+    EXPECT_GT(removed_alternative_number, 0);
+    EXPECT_GT(feasible_instance_number, 0);
+}
+
+TEST(Reduction, RemovedAlternativeLayout)
+{
+    InstanceBuilder builder(2, 2);
+    builder.set_capacity(0, 10);
+    builder.set_capacity(1, 10);
+    builder.set_alternative(0, 0, 1, 1);
+    builder.set_alternative(0, 1, 1, 2);
+    builder.set_alternative(1, 0, 1, 3);
+    builder.set_alternative(1, 1, 1, 4);
+    builder.remove_alternative(0, 1);
+    Instance instance = builder.build();
+    for (MatrixLayout layout: {MatrixLayout::AgentMajor, MatrixLayout::ItemMajor}) {
+        instance.set_matrix_layout(layout);
+        EXPECT_TRUE(instance.eligible(0, 0));
+        EXPECT_FALSE(instance.eligible(0, 1));
+        EXPECT_TRUE(instance.eligible(1, 0));
+        EXPECT_TRUE(instance.eligible(1, 1));
+    }
+    EXPECT_EQ(instance.eligible_agents(0).size(), 1);
+    EXPECT_EQ(instance.eligible_items(1).size(), 1);
+}
+
+TEST(Reduction, PreRemovedAlternative)
+{
+    // Alternative (0, 1) is removed from the original instance, it must stay
+    // removed in the reduced instance.
+    InstanceBuilder builder(3, 2);
+    builder.set_capacity(0, 10);
+    builder.set_capacity(1, 10);
+    builder.set_alternative(0, 0, 2, 5);
+    builder.set_alternative(0, 1, 2, 1);
+    builder.set_alternative(1, 0, 3, 2);
+    builder.set_alternative(1, 1, 3, 2);
+    builder.set_alternative(2, 0, 4, 3);
+    builder.set_alternative(2, 1, 4, 1);
+    builder.remove_alternative(0, 1);
+    Instance instance = builder.build();
+    for (bool remove_dominated_alternatives: {false, true}) {
+        ReductionOptionalParameters parameters;
+        parameters.remove_dominated_alternatives = remove_dominated_alternatives;
+        Reduction reduction = reduce(instance, parameters);
+        const Instance& instance_reduced = reduction.instance;
+        EXPECT_FALSE(instance_reduced.eligible(0, 1));
+        EXPECT_EQ(instance_reduced.eligible_agents(0).size(), 1);
+        EXPECT_EQ(reduction.fixed_agents[0], 0);
+        for (ItemIdx j = 0; j < instance.item_number(); ++j) {
+            for (AgentIdx i = 0; i < instance.agent_number(); ++i) {
+                if (!instance.eligible(j, i)) {
+                    EXPECT_FALSE(instance_reduced.eligible(j, i));
+                }
+            }
+        }
+        // Only the alternatives eligible in the original instance are
+        // counted as removed by the reduction.
+        Counter removed = 0;
+        for (ItemIdx j = 0; j < instance.item_number(); ++j)
+            for (AgentIdx i = 0; i < instance.agent_number(); ++i)
+                if (instance.eligible(j, i) && !instance_reduced.eligible(j, i))
+                    removed++;
+        EXPECT_EQ(removed, reduction.removed_alternative_number);
+    }
+}
+
+TEST(Reduction, ReducedCostFixing)
+{
+    Counter fixed_alternative_number = 0;
+    for (Seed seed = 0; seed < 20; ++seed) {
+        Instance instance = reduction_instance_test(8, 3, seed);
+        ItemIdx n = instance.item_number();
+        AgentIdx m = instance.agent_number();
+
+        // Optimal value and cost of every feasible solution.
+        std::vector<Cost> costs;
+        reduction_enumerate(instance, [&](const Solution& solution)
+        {
+            costs.push_back(solution.cost());
+        });
+        if (costs.empty())
+            continue;
+        std::sort(costs.begin(), costs.end());
+        Cost opt = costs.front();
+
+        // Combinatorial relaxation: each item is assigned to its cheapest
+        // eligible agent; fixing xij to 1 increases it by cij - cmin(j).
+        Cost lower_bound = 0;
+        std::vector<std::vector<double>> reduced_costs(n, std::vector<double>(m, 0));
+        for (ItemIdx j = 0; j < n; ++j) {
+            Cost c_min = instance.bound();
+            for (AgentIdx i: instance.eligible_agents(j))
+                c_min = std::min(c_min, instance.cost(j, i));
+            lower_bound += c_min;
+            for (AgentIdx i: instance.eligible_agents(j))
+                reduced_costs[j][i] = instance.cost(j, i) - c_min;
+        }
+
+        // With the optimal value plus one as upper bound, the optimal
+        // solutions are kept; with the median cost, every solution strictly
+        // better than it.
+        for (Cost upper_bound: {opt + 1, costs[costs.size() / 2]}) {
+            std::vector<std::vector<int>> fixed_alt = reduced_cost_fixing(
+                    instance, lower_bound, reduced_costs, upper_bound);
+            for (ItemIdx j = 0; j < n; ++j) {
+                for (AgentIdx i = 0; i < m; ++i) {
+                    if (!instance.eligible(j, i)) {
+                        EXPECT_EQ(fixed_alt[j][i], 0);
+                    } else if (fixed_alt[j][i] != -1) {
+                        fixed_alternative_number++;
+                    }
+                }
+            }
+            reduction_enumerate(instance, [&](const Solution& solution)
+            {
+                if (solution.cost() >= upper_bound)
+                    return;
+                for (ItemIdx j = 0; j < n; ++j) {
+                    for (AgentIdx i = 0; i < m; ++i) {
+                        if (solution.agent(j) == i) {
+                            EXPECT_NE(fixed_alt[j][i], 0);
+                        } else {
+                            EXPECT_NE(fixed_alt[j][i], 1);
+                        }
+                    }
+                }
+            });
+        }
+    }
+    // Make sure some eligible alternatives are actually fixed.
+    EXPECT_GT(fixed_alternative_number, 0);
+}
+
+TEST(Reduction, ReducedCostFixingFractionalBound)
+{
+    // With a bound of 10.1, fixing xij to 1 with a reduced cost of 0.5 leads
+    // to a bound of 11, so xij must not be fixed to 0 with an upper bound of
+    // 12; with a reduced cost of 1.95, it leads to a bound of 13.
+    InstanceBuilder builder(1, 3);
+    for (AgentIdx i = 0; i < 3; ++i) {
+        builder.set_capacity(i, 10);
+        builder.set_alternative(0, i, 1, 10);
+    }
+    Instance instance = builder.build();
+    std::vector<std::vector<int>> fixed_alt = reduced_cost_fixing(
+            instance, 10.1, {{0, 0.5, 1.95}}, 12);
+    EXPECT_EQ(fixed_alt[0][0], -1);
+    EXPECT_EQ(fixed_alt[0][1], -1);
+    EXPECT_EQ(fixed_alt[0][2], 0);
+
+    // Lagrangian relaxation of the capacity constraints with fractional
+    // multipliers mu_i <= 0: every solution costs at least
+    // sum_i mu_i ti + sum_j min_i (cij - mu_i wij), and fixing xij to 1
+    // increases this bound by the reduced cost of xij.
+    Counter fixed_alternative_number = 0;
+    for (Seed seed = 0; seed < 20; ++seed) {
+        Instance instance = reduction_instance_test(8, 3, seed);
+        ItemIdx n = instance.item_number();
+        AgentIdx m = instance.agent_number();
+        std::vector<Cost> costs;
+        reduction_enumerate(instance, [&](const Solution& solution)
+        {
+            costs.push_back(solution.cost());
+        });
+        if (costs.empty())
+            continue;
+        std::sort(costs.begin(), costs.end());
+
+        std::mt19937_64 generator(seed);
+        std::uniform_real_distribution<double> d_multiplier(-1.5, 0);
+        std::vector<double> multipliers(m);
+        double lower_bound = 0;
+        for (AgentIdx i = 0; i < m; ++i) {
+            multipliers[i] = d_multiplier(generator);
+            lower_bound += multipliers[i] * instance.capacity(i);
+        }
+        std::vector<std::vector<double>> reduced_costs(n, std::vector<double>(m, 0));
+        for (ItemIdx j = 0; j < n; ++j) {
+            double rc_min = std::numeric_limits<double>::infinity();
+            for (AgentIdx i: instance.eligible_agents(j))
+                rc_min = std::min(rc_min, instance.cost(j, i) - multipliers[i] * instance.weight(j, i));
+            lower_bound += rc_min;
+            for (AgentIdx i: instance.eligible_agents(j))
+                reduced_costs[j][i] = instance.cost(j, i) - multipliers[i] * instance.weight(j, i) - rc_min;
+        }
+
+        for (Cost upper_bound: {costs.front() + 1, costs[costs.size() / 2]}) {
+            std::vector<std::vector<int>> fixed_alt = reduced_cost_fixing(
+                    instance, lower_bound, reduced_costs, upper_bound);
+            for (ItemIdx j = 0; j < n; ++j)
+                for (AgentIdx i: instance.eligible_agents(j))
+                    if (fixed_alt[j][i] != -1)
+                        fixed_alternative_number++;
+            reduction_enumerate(instance, [&](const Solution& solution)
+            {
+                if (solution.cost() >= upper_bound)
+                    return;
+                for (ItemIdx j = 0; j < n; ++j) {
+                    for (AgentIdx i = 0; i < m; ++i) {
+                        if (solution.agent(j) == i) {
+                            EXPECT_NE(fixed_alt[j][i], 0);
+                        } else {
+                            EXPECT_NE(fixed_alt[j][i], 1);
+                        }
+                    }
+                }
+            });
+
+            // The reduced instance keeps these solutions.
+            Reduction reduction = reduce(instance, fixed_alt);
+            reduction_enumerate(instance, [&](const Solution& solution)
+            {
+                if (solution.cost() >= upper_bound)
+                    return;
+                for (ItemIdx j = 0; j < n; ++j) {
+                    EXPECT_TRUE(reduction.instance.eligible(j, solution.agent(j)));
+                }
+            });
+        }
+    }
+    EXPECT_GT(fixed_alternative_number, 0);
+}
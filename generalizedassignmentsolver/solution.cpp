@@ -334,9 +334,8 @@ void Output::print(Info& info, const std::stringstream& s) const
 
 void Output::update_solution(const Solution& solution_new, const std::stringstream& s, Info& info)
 {
-    if (!compare(solution, solution_new))
-        return;
-
+    // The incumbent is only read under the lock, since other threads may be
+    // updating it.
     info.output->mutex_sol.lock();
 
     if (compare(solution, solution_new)) {
@@ -357,9 +356,6 @@ void Output::update_solution(const Solution& solution_new, const std::stringstre
 
 void Output::update_lower_bound(Cost lower_bound_new, const std::stringstream& s, Info& info)
 {
-    if (lower_bound != -1 && lower_bound >= lower_bound_new)
-        return;
-
     info.output->mutex_sol.lock();
 
     if (lower_bound == -1 || lower_bound < lower_bound_new) {
@@ -40,6 +40,11 @@ public:
 
     inline Weight overcapacity()           const { return total_overcapacity_; };
     inline Weight overcapacity(AgentIdx i) const { return agents_[i].overcapacity; };
+    /** Overcapacity variation of agent i if its weight varies by w. */
+    inline Weight overcapacity_delta(AgentIdx i, Weight w) const
+    {
+        return std::max((Weight)0, weight(i) + w - instance().capacity(i)) - overcapacity(i);
+    }
 
     inline Cost cost()           const { return total_cost_; }
     inline Cost cost(AgentIdx i) const { return agents_[i].cost; }
@@ -47,6 +52,7 @@ public:
 
     inline PCost pcost()           const { return total_pcost_; }
     inline PCost pcost(AgentIdx i) const { return agents_[i].pcost; }
+    inline PCost penalty(AgentIdx i) const { return agents_[i].penalty; }
 
     inline double comp() const { return comp_; }
 